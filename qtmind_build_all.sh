@@ -63,7 +63,7 @@ make clean
 
 make
 
-cp release/qtmind.exe ../
+cp src/release/qtmind.exe ../
 
 cd ../..
 
@@ -79,7 +79,7 @@ make clean
 
 make
 
-cp release/qtmind.exe ../
+cp src/release/qtmind.exe ../
 
 cd ../..
 
@@ -90,9 +90,9 @@ cd android
 
 /opt/android-qt5/5.3.0/bin/qmake ../../QtMind/
 
-make install INSTALL_ROOT=android-build/
+make install INSTALL_ROOT=$PWD/android-build/
 
-/opt/android-qt5/5.3.0/bin/androiddeployqt --output android-build/ --sign ../../../android_release.keystore nikta --input android-libqtmind.so-deployment-settings.json
+/opt/android-qt5/5.3.0/bin/androiddeployqt --output android-build/ --sign ../../../android_release.keystore nikta --input src/android-libqtmind.so-deployment-settings.json
 
 mv -f android-build/bin/QtApp-release.apk ../../../../gh-pages/Downloads/QtMind.apk
 
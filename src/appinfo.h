@@ -45,7 +45,20 @@ enum class Algorithm
 {
     MOST_PARTS,
     WORST_CASE,
-    EXPECTED_SIZE
+    EXPECTED_SIZE,
+    ENTROPY,
+    OPTIMAL     // the optimal tree of the opening book, Expected Size if there is none
+};
+/**
+ * @brief The Solving Engine enum
+ */
+enum class Engine
+{
+    ONE_STEP,   // weights the candidates one guess ahead
+    LOOKAHEAD,  // weights the best candidates two guesses ahead
+    AUTO,       // chooses the best engine that fits the latency of a turn
+    SAMPLED,    // weights a sample of the candidates, only chosen by AUTO
+    RANDOM      // guesses a possible without weighting, only chosen by AUTO
 };
 /**
  * @brief The Game Mode enum
@@ -0,0 +1,31 @@
+# The board of the game, shared by the game and the GUI benchmark, on top of core.pri
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+	$$PWD/game.cpp \
+	$$PWD/peg.cpp \
+	$$PWD/box.cpp \
+	$$PWD/pegbox.cpp \
+	$$PWD/pinbox.cpp \
+	$$PWD/pin.cpp \
+	$$PWD/button.cpp \
+	$$PWD/message.cpp \
+	$$PWD/tools.cpp \
+	$$PWD/latencyhistogram.cpp \
+	$$PWD/latencystats.cpp
+
+HEADERS += \
+	$$PWD/game.h \
+	$$PWD/peg.h \
+	$$PWD/box.h \
+	$$PWD/pegbox.h \
+	$$PWD/pinbox.h \
+	$$PWD/pin.h \
+	$$PWD/button.h \
+	$$PWD/message.h \
+	$$PWD/tools.h \
+	$$PWD/ipegconnector.h \
+	$$PWD/latencyhistogram.h \
+	$$PWD/latencystats.h
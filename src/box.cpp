@@ -18,6 +18,7 @@
  ***********************************************************************/
 
 #include "box.h"
+#include "tracer.h"
 #include <QPen>
 #include <QBrush>
 #include <QPainter>
@@ -43,6 +44,7 @@ void Box::setState(const Box::State& _state)
 
 void Box::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
 {
+    TRACE_SCOPE("Box::paint", "paint");
     painter->setPen(Qt::NoPen);
 
     painter->setBrush(QBrush(QColor(225, 225, 225, sBoxAlphas[(int)mState])));
@@ -0,0 +1,173 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "codetables.h"
+#include "appinfo.h"
+#include <QtCore/qmath.h>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+
+QSharedPointer<const CodeTables> CodeTables::acquire(const int& colors, const int& pegs, const bool& same_colors)
+{
+    static QMutex mutex;
+    static QWaitCondition built;
+    static QHash<int, QWeakPointer<const CodeTables> > cache;
+    static QSet<int> building; /**< the configurations being built by some thread */
+    const int key = (colors*(MAX_SLOT_NUMBER + 1) + pegs)*2 + (same_colors ? 1 : 0);
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<const CodeTables> tables;
+    forever {
+        tables = cache.value(key).toStrongRef();
+        if (tables)
+            return tables;
+        // wait for the tables being built, for example by the prewarmer
+        if (!building.contains(key))
+            break;
+        built.wait(&mutex);
+    }
+
+    // build without the lock, so that the other configurations are not blocked
+    building.insert(key);
+    locker.unlock();
+    tables = QSharedPointer<const CodeTables>(new CodeTables(colors, pegs, same_colors));
+    locker.relock();
+
+    building.remove(key);
+    cache.insert(key, tables.toWeakRef());
+    built.wakeAll();
+    return tables;
+}
+
+int CodeTables::count(const int& colors, const int& pegs, const bool& same_colors)
+{
+    int size = 1;
+    for(int i = 0; i < pegs; ++i)
+        size *= same_colors ? colors : (colors - i);
+    return size;
+}
+
+CodeTables::CodeTables(const int& colors, const int& pegs, const bool& same_colors):
+    mColors(colors),
+    mPegs(pegs),
+    mSameColors(same_colors)
+{
+    mSize = count(mColors, mPegs, mSameColors);
+
+    mCodes.resize(mSize*mPegs);
+    unsigned char* codes = mCodes.data();
+    for (int i = 0; i < mPegs; i++)
+        codes[i] = mSameColors ? 0 : i;
+    for (int i = 1; i < mSize; i++) {
+        unsigned char* X = codes + i*mPegs;
+        for(int j = 0; j < mPegs; ++j)
+            X[j] = X[j - mPegs];
+        if (mSameColors)
+            nextCodeSameColor(X);
+        else
+            nextCodeDifferentColor(X);
+    }
+
+    // the multiset of a code, as the number of times each color is in it
+    QHash<qint64, int> group_of_multiset;
+    mGroups.resize(mSize);
+    for(int i = 0; i < mSize; ++i) {
+        unsigned char count[MAX_COLOR_NUMBER] = {0};
+        for(int j = 0; j < mPegs; ++j)
+            ++count[codes[i*mPegs + j]];
+        qint64 multiset = 0;
+        for(int c = 0; c < mColors; ++c)
+            multiset = multiset*(mPegs + 1) + count[c];
+        if (!group_of_multiset.contains(multiset)) {
+            group_of_multiset.insert(multiset, group_of_multiset.size());
+            for(int c = 0; c < mColors; ++c)
+                mCounts.append(count[c]);
+        }
+        mGroups[i] = group_of_multiset.value(multiset);
+    }
+
+    mGroupsSize = group_of_multiset.size();
+    mTotals.resize(mGroupsSize*mGroupsSize);
+    for(int a = 0; a < mGroupsSize; ++a) {
+        for(int b = 0; b < mGroupsSize; ++b) {
+            int total = 0;
+            for(int c = 0; c < mColors; ++c)
+                total += qMin(mCounts.at(a*mColors + c), mCounts.at(b*mColors + c));
+            mTotals[a*mGroupsSize + b] = total;
+        }
+    }
+
+    mEntropyTable.resize(mSize + 1);
+    mEntropyTable[0] = 0;
+    for(int i = 1; i < mEntropyTable.size(); ++i)
+        mEntropyTable[i] = qRound64(ENTROPY_SCALE*i*qLn(i)/qLn(2.0));
+}
+
+QVector<unsigned char> CodeTables::totals(const unsigned char* guess) const
+{
+    unsigned char count[MAX_COLOR_NUMBER] = {0};
+    for(int i = 0; i < mPegs; ++i)
+        ++count[guess[i]];
+
+    QVector<unsigned char> group_totals(mGroupsSize);
+    for(int g = 0; g < mGroupsSize; ++g) {
+        int total = 0;
+        for(int c = 0; c < mColors; ++c)
+            total += qMin(mCounts.at(g*mColors + c), count[c]);
+        group_totals[g] = total;
+    }
+    return group_totals;
+}
+
+void CodeTables::nextCodeSameColor(unsigned char* X) const
+{
+    int i = mPegs - 1;
+    int N = mColors;
+    N--;
+    while (i >= 0 && X[i] >= N)
+        X[i--] = 0;
+    if (i < 0) return;
+    X[i]++;
+}
+
+void CodeTables::nextCodeDifferentColor(unsigned char* X) const
+{
+    int i = mPegs;
+    while (--i >= 0) {
+        while (++X[i] < mColors) {
+            int j = 0;
+            while (j < i && X[j] != X[i])
+                ++j;
+            if (j == i) goto mark;
+        }
+    }
+    return;
+mark:
+    while (++i < mPegs) {
+        X[i] = -1;
+        while (++X[i] < mColors) {
+            int j = 0;
+            while (j < i && X[j] != X[i])
+                ++j;
+            if (j == i) break;
+        }
+    }
+}
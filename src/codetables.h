@@ -0,0 +1,138 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef CODETABLES_H
+#define CODETABLES_H
+
+#include <QSharedPointer>
+#include <QVector>
+
+/**    @brief The class CodeTables holds the immutable tables of a configuration:
+ *    all the codes, the color multiset group of each code, the total (blacks +
+ *    whites) of every two groups and the entropy table. The tables are shared by
+ *    all the solvers of the same configuration, and they live as long as some
+ *    solver holds them.
+ *
+ *    The total of two codes only depends on their multisets, since
+ *          \f[ blacks + whites = \sum_{c} \min(A_c, B_c) \f]
+ *    where \f$ A_c \f$ is the number of times the color c is in the code A, so
+ *    the response of two codes needs only the blacks to be counted.
+ */
+class CodeTables
+{
+public:
+
+    static const int ENTROPY_SCALE = 1 << 12; /**< The fixed point scale of the entropy table */
+
+    /**
+     * @brief acquire the tables of a configuration, built if no one holds them
+     * @param colors the number of colors
+     * @param pegs the number of pegs
+     * @param same_colors same color allowed flag
+     * @return QSharedPointer<const CodeTables> the shared tables
+     */
+    static QSharedPointer<const CodeTables> acquire(const int& colors, const int& pegs, const bool& same_colors);
+    /**
+     * @brief count the number of codes of a configuration, without the tables
+     * @param colors the number of colors
+     * @param pegs the number of pegs
+     * @param same_colors same color allowed flag
+     * @return int the number of codes
+     */
+    static int count(const int& colors, const int& pegs, const bool& same_colors);
+
+    int colors() const {return mColors;}
+    int pegs() const {return mPegs;}
+    bool sameColors() const {return mSameColors;}
+    /**
+     * @brief size the number of codes
+     */
+    int size() const {return mSize;}
+    /**
+     * @brief code the colors of a code
+     * @param index the index of the code
+     * @return const unsigned char* pegs colors
+     */
+    const unsigned char* code(const int& index) const {return mCodes.constData() + index*mPegs;}
+    /**
+     * @brief response the response index f(b, w) of two codes
+     * @param a the index of the first code
+     * @param b the index of the second code
+     * @return int the response index
+     */
+    int response(const int& a, const int& b) const
+    {
+        const unsigned char* A = code(a);
+        const unsigned char* B = code(b);
+        int blacks = 0;
+        for(int i = 0; i < mPegs; ++i)
+            blacks += (A[i] == B[i]);
+        int total = mTotals.constData()[mGroups.constData()[a]*mGroupsSize + mGroups.constData()[b]];
+        return total*(total + 1)/2 + blacks;
+    }
+    /**
+     * @brief group the multiset group of a code
+     * @param index the index of the code
+     * @return int the group of the code
+     */
+    int group(const int& index) const {return mGroups.constData()[index];}
+    /**
+     * @brief totals the total (blacks + whites) of a guess with each multiset
+     * group, the guess need not be a code of the configuration
+     * @param guess pegs colors
+     * @return QVector<unsigned char> the total of each group
+     */
+    QVector<unsigned char> totals(const unsigned char* guess) const;
+    /**
+     * @brief entropy n*log2(n) in fixed point
+     * @param n the size of a part, at most the number of codes
+     * @return qint64 the scaled n*log2(n), which passes the int range above some 34000
+     */
+    qint64 entropy(const int& n) const {return mEntropyTable.constData()[n];}
+
+private:
+    CodeTables(const int& colors, const int& pegs, const bool& same_colors);
+
+    /**
+     * @brief find the next code of a code when same color is allowed
+     * @param X the code
+     */
+    void nextCodeSameColor(unsigned char* X) const;
+    /**
+     * @brief find the next code of a code when same color is not allowed
+     * @param X the code
+     */
+    void nextCodeDifferentColor(unsigned char* X) const;
+
+private:
+    int mColors; /**< the number of colors */
+    int mPegs; /**< the number of pegs */
+    bool mSameColors; /**< same color allowed flag */
+    int mSize; /**< the number of codes */
+    QVector<unsigned char> mCodes; /**< all the codes, pegs colors for each code */
+    QVector<int> mGroups; /**< the multiset group of each code */
+    int mGroupsSize; /**< the number of multiset groups */
+    QVector<unsigned char> mCounts; /**< the number of times each color is in each group */
+    QVector<unsigned char> mTotals; /**< blacks + whites of every two groups */
+    QVector<qint64> mEntropyTable; /**< n*log2(n) in fixed point, for the entropy weight */
+
+    friend class SolverBenchmark;
+};
+
+#endif // CODETABLES_H
@@ -0,0 +1,32 @@
+# The solving engine, shared by the game and the command line tools
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
+
+# qmake CONFIG+=qtmind_metrics counts what each guess of the solver costs
+qtmind_metrics: DEFINES += QTMIND_METRICS
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+	$$PWD/solver.cpp \
+	$$PWD/codetables.cpp \
+	$$PWD/prewarmer.cpp \
+	$$PWD/guess.cpp \
+	$$PWD/openingbook.cpp \
+	$$PWD/gamerecord.cpp \
+	$$PWD/optimalstrategy.cpp \
+	$$PWD/transpositiontable.cpp \
+	$$PWD/tracer.cpp
+
+HEADERS += \
+	$$PWD/appinfo.h \
+	$$PWD/solver.h \
+	$$PWD/codetables.h \
+	$$PWD/prewarmer.h \
+	$$PWD/guess.h \
+	$$PWD/openingbook.h \
+	$$PWD/gamerecord.h \
+	$$PWD/optimalstrategy.h \
+	$$PWD/transpositiontable.h \
+	$$PWD/tracer.h
@@ -22,10 +22,25 @@
 #include "pegbox.h"
 #include "pinbox.h"
 #include "solver.h"
+#include "codetables.h"
+#include "transpositiontable.h"
+#include "prewarmer.h"
+#include "gamerecord.h"
+#include "latencystats.h"
 #include "message.h"
 #include "tools.h"
+#include "tracer.h"
 #include "ctime"
 #include <QSettings>
+#include <QStringList>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+static const quint32 MAGIC = 0x514d5347; /**< "QMSG", the magic number of the saved game file */
+static const quint16 VERSION = 1; /**< the version of the saved game file */
 
 inline static void setStateOfList(QList<PegBox*>* boxlist, const Box::State& state_t)
 {
@@ -33,20 +48,60 @@ inline static void setStateOfList(QList<PegBox*>* boxlist, const Box::State& sta
         box->setState(state_t);
 }
 
+inline static void writeBoxes(QDataStream& out, const QList<PegBox*>& boxlist)
+{
+    foreach (PegBox* box, boxlist) {
+        out << (quint8) box->hasPeg() << (quint8) (box->hasPeg() ? box->getPegColor() : 0);
+        out << (quint8) box->getPegState() << (quint8) box->getState();
+    }
+}
+
+inline static bool readBoxes(QDataStream& in, const QList<PegBox*>& boxlist, const int& colors,
+                             IPegConnector* peg_connector)
+{
+    foreach (PegBox* box, boxlist) {
+        quint8 has_peg, color, peg_state, box_state;
+        in >> has_peg >> color >> peg_state >> box_state;
+        if (in.status() != QDataStream::Ok || color >= colors || peg_state > (quint8) Peg::State::PLAIN ||
+                box_state > (quint8) Box::State::NONE)
+            return false;
+        if (has_peg)
+            box->setPegColor(color, peg_connector);
+        // the box state changes the peg state, so the peg state comes after
+        box->setState((Box::State) box_state);
+        if (has_peg)
+            box->setPegState((Peg::State) peg_state);
+    }
+    return true;
+}
+
 Game::Game():
     QGraphicsView(),
     mState(State::None),
-    mSolver(0)
+    mSolver(0),
+    mSolverReady(false),
+    mFirstFrameShown(false),
+    mGuessElapsed(0)
 {
     QSettings settings;
     Peg::setShowColors(settings.value("ShowColors", 1).toBool());
     Peg::setShowIndicators(settings.value("ShowIndicators", 0).toBool());
     Peg::setIndicator((Indicator) settings.value("Indicator", 65).toInt());
     mMode = (Mode) settings.value("Mode", 1).toInt();
+    mEngine = (Engine) settings.value("Engine", 0).toInt();
+    mGuess.mAlgorithm = (Algorithm) settings.value("Algorithm", 0).toInt();
     mSameColors = settings.value("SameColor", true).toBool();
     mPegs = settings.value("Pegs", 4).toInt();
     mColors = settings.value("Colors", 6).toInt();
 
+    // the tables of the saved configuration are built while the window is set up
+    mPrewarmer = new Prewarmer(this);
+    prewarm();
+
+    QDir().mkpath(QFileInfo(dataFileName("qtmind.record")).absolutePath());
+    mRecord = new GameRecord;
+    mRecord->open(dataFileName("qtmind.record"));
+
     auto scene = new QGraphicsScene(this);
     setScene(scene);
     scene->setSceneRect(0, 0, 320, 560);
@@ -65,6 +120,8 @@ Game::~Game()
     settings.setValue("ShowIndicators", (int) Peg::getShowIndicators());
     settings.setValue("Indicator", (int) Peg::getIndicator());
     settings.setValue("Mode", (int) mMode);
+    settings.setValue("Engine", (int) mEngine);
+    settings.setValue("Algorithm", (int) mGuess.mAlgorithm);
     settings.setValue("SameColor", mSameColors);
     settings.setValue("Pegs", mPegs);
     settings.setValue("Colors", mColors);
@@ -75,6 +132,9 @@ Game::~Game()
         mSolver->wait();
         mSolver->deleteLater();
     }
+    TranspositionTable::instance()->save();
+    LatencyStats::instance()->save();
+    delete mRecord;
 
     scene()->clear();
 }
@@ -198,7 +258,8 @@ void Game::setNextRowInAction()
 void Game::getNextGuess()
 {
     mState = State::Thinking;
-    mSolver->startGuessing(algorithm());
+    mGuessTimer.start();
+    mSolver->startGuessing(algorithm(), engine());
 }
 
 Game::Player Game::winner() const
@@ -223,6 +284,7 @@ void Game::connectPegToGame(Peg *peg)
 
 void Game::initializeScene()
 {
+    TRACE_SCOPE("Game::initializeScene", "game");
     mCodeBoxes.clear();
     mPinBoxes.clear();
     mPegBoxes.clear();
@@ -386,33 +448,19 @@ void Game::onResigned()
 void Game::onOkButtonPressed()
 {
     if(mode() == Mode::MVH) {
+        mResponseTimer.start();
         int blacks, whites;
         mPinBoxes.at(mMovesPlayed)->getValue(blacks, whites);
+        // the locating of the last contradictory response may be running
+        mSolver->interupt();
+        mSolver->wait();
         if(!mSolver->setResponse(blacks, whites, mGuess.mGuess)) {
             mMessage->setText(tr("Not Possible, Try Again"));
+            mSolver->startLocating(blacks, whites, mGuess.mGuess);
             return;
         }
         emit buttonClickSignal();
-        mOkButton->setVisible(false);
-
-        mPinBoxes.at(mMovesPlayed)->setState(Box::State::PAST);
-
-        switch (winner()) {
-        case Player::CodeBreaker:
-            mState = State::Win;
-            freezeScene();
-            break;
-        case Player::CodeMaker:
-            mState = State::Lose;
-            freezeScene();
-            break;
-        default:
-            ++mMovesPlayed;
-            getNextGuess();
-            break;
-        }
-
-        showMessage();
+        responseAccepted();
     } else {
         emit buttonClickSignal();
         mState = State::Running;
@@ -449,10 +497,112 @@ void Game::onOkButtonPressed()
     }
 }
 
+void Game::responseAccepted()
+{
+    mOkButton->setVisible(false);
+
+    int blacks, whites;
+    mPinBoxes.at(mMovesPlayed)->getValue(blacks, whites);
+    mRecord->addTurn(mGuess.mGuess, blacks, whites, mGuessElapsed);
+
+    mPinBoxes.at(mMovesPlayed)->setState(Box::State::PAST);
+
+    switch (winner()) {
+    case Player::CodeBreaker:
+        mState = State::Win;
+        freezeScene();
+        break;
+    case Player::CodeMaker:
+        mState = State::Lose;
+        freezeScene();
+        break;
+    default:
+        ++mMovesPlayed;
+        getNextGuess();
+        break;
+    }
+
+    showMessage();
+}
+
+void Game::waitForResponse()
+{
+    mState = State::WaittingOkButtonPress;
+    showMessage();
+    mPinBoxes.at(mMovesPlayed)->setState(Box::State::NONE);
+    mOkButton->setEnabled(true);
+    mOkButton->setVisible(true);
+    mOkButton->setPos(mPinBoxes.at(mMovesPlayed)->pos()-QPoint(0, 39));
+}
+
+void Game::onUndo()
+{
+    if (mode() != Mode::MVH || !mSolver || !mSolver->canUndo())
+        return;
+    if (mState != State::Thinking && mState != State::WaittingOkButtonPress &&
+            mState != State::Win && mState != State::Lose)
+        return;
+
+    mSolver->interupt();
+    mSolver->wait();
+    emit buttonClickSignal();
+
+    // the row of the next guess is cleared, a finished game has none
+    if (mState == State::Thinking || mState == State::WaittingOkButtonPress) {
+        for(int i = mMovesPlayed*pegs(); i < (mMovesPlayed + 1)*pegs(); ++i)
+            mCodeBoxes.at(i)->setState(Box::State::FUTURE);
+        mPinBoxes.at(mMovesPlayed)->setPins(0, 0);
+        mPinBoxes.at(mMovesPlayed)->setState(Box::State::FUTURE);
+        --mMovesPlayed;
+    }
+
+    mSolver->undoResponse();
+    mRecord->undoTurn();
+    // the guess is shown again, it is not timed
+    mGuessElapsed = 0;
+    mResponseTimer.invalidate();
+    unsigned char guess[MAX_SLOT_NUMBER];
+    for(int i = 0; i < pegs(); ++i)
+        guess[i] = mCodeBoxes.at(mMovesPlayed*pegs() + i)->getPegColor();
+    mGuess.setGuess(mPegs, mColors, guess);
+
+    waitForResponse();
+    showInformation();
+}
+
+void Game::onRedo()
+{
+    if (mode() != Mode::MVH || !mSolver || mState != State::WaittingOkButtonPress)
+        return;
+
+    mSolver->interupt();
+    mSolver->wait();
+    int blacks, whites;
+    if (!mSolver->redoResponse(blacks, whites))
+        return;
+    emit buttonClickSignal();
+    mPinBoxes.at(mMovesPlayed)->setPins(blacks, whites);
+    responseAccepted();
+}
+
+void Game::onLocatingDone()
+{
+    if (mState != State::WaittingOkButtonPress)
+        return;
+
+    QList<int> rows = mSolver->suspectRows();
+    QStringList row_numbers;
+    foreach(int row, rows)
+        row_numbers.append(mTools->mLocale.toString(row + 1));
+    mMessage->setText(QString("%1, %2").arg(tr("Not Possible")).
+                      arg(tr("Check Row(s) %1", "", rows.size()).arg(row_numbers.join(", "))));
+}
+
 void Game::onDoneButtonPressed()
 {
     emit buttonClickSignal();
     mState = State::Running;
+    prepareSolver();
 
     mDoneButton->setVisible(false);
     mDoneButton->setEnabled(false);
@@ -464,6 +614,7 @@ void Game::onDoneButtonPressed()
     for(int i = 0; i < pegs(); ++i)
         new_guess[i] = mCurrentBoxes.at(i)->getPegColor();
     mGuess.setCode(mPegs, new_guess);
+    mRecord->beginGame(colors(), pegs(), isSameColors(), algorithm(), engine(), new_guess);
 
     mCurrentBoxes.clear();
     getNextGuess();
@@ -472,7 +623,12 @@ void Game::onDoneButtonPressed()
 
 void Game::onGuessReady()
 {
+    TRACE_SCOPE("Game::onGuessReady", "game");
+    // a guess that is undone before it arrives is dropped
+    if (mState != State::Thinking)
+        return;
     mState = State::Running;
+    mGuessElapsed = mGuessTimer.nsecsElapsed()/1000;
     showInformation();
 
     int box_index = mMovesPlayed*pegs();
@@ -480,12 +636,17 @@ void Game::onGuessReady()
         mCodeBoxes.at(box_index + i)->setPegColor(mGuess.mGuess[i], this);
         mCodeBoxes.at(box_index + i)->setState(Box::State::PAST);
     }
-    mState = State::WaittingOkButtonPress;
-    showMessage();
-    mPinBoxes.at(mMovesPlayed)->setState(Box::State::NONE);
-    mOkButton->setEnabled(true);
-    mOkButton->setVisible(true);
-    mOkButton->setPos(mPinBoxes.at(mMovesPlayed)->pos()-QPoint(0, 39));
+    waitForResponse();
+
+    LatencyStats* stats = LatencyStats::instance();
+    stats->record(LatencyStats::Latency::SOLVER, colors(), pegs(), isSameColors(), algorithm(),
+                  mMovesPlayed + 1, mGuessElapsed);
+    // the first guess and the guesses after an undo follow no response
+    if (mResponseTimer.isValid()) {
+        stats->record(LatencyStats::Latency::RESPONSE, colors(), pegs(), isSameColors(), algorithm(),
+                      mMovesPlayed + 1, mResponseTimer.nsecsElapsed()/1000);
+        mResponseTimer.invalidate();
+    }
 
     if (mTools->mAutoPutPins)
         mPinBoxes.at(mMovesPlayed)->setPins(mGuess.mBlacks, mGuess.mWhites);
@@ -494,7 +655,9 @@ void Game::onGuessReady()
 void Game::play()
 {
     stop();
+    mResponseTimer.invalidate();
     mGuess.reset(algorithm(), 0);
+    prewarm();
 
     if(mode() == Mode::MVH)
         playMVH();
@@ -502,6 +665,16 @@ void Game::play()
         playHVM();
 }
 
+void Game::prewarm()
+{
+#ifdef Q_OS_ANDROID
+    // the neighbors are not worth their memory on phones
+    mPrewarmer->prewarm(colors(), pegs(), isSameColors(), false);
+#else
+    mPrewarmer->prewarm(colors(), pegs(), isSameColors());
+#endif
+}
+
 void Game::stop()
 {
     if (mSolver) {
@@ -509,23 +682,169 @@ void Game::stop()
         mSolver->quit();
         mSolver->wait();
     }
+    mSolverReady = false;
     initializeScene();
     mState = State::None;
 }
 
+bool Game::save()
+{
+    if (!isRunning())
+        return false;
+    // the solver writes the guess and its own state while it thinks, it is
+    // stopped before they are saved, and thinks over if the game is not saved
+    if (mSolver) {
+        mSolver->interupt();
+        mSolver->wait();
+    }
+
+    QString name = dataFileName("qtmind.save");
+    QDir().mkpath(QFileInfo(name).absolutePath());
+    QFile file(name);
+    bool saved = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (saved) {
+        QDataStream out(&file);
+        out << MAGIC << VERSION;
+        out << (quint8) mMode << (quint8) mColors << (quint8) mPegs << (quint8) mSameColors;
+        out << (quint8) algorithm() << (quint8) mEngine << (quint8) mState << (quint8) mMovesPlayed;
+        for(int i = 0; i < MAX_SLOT_NUMBER; ++i)
+            out << mGuess.mGuess[i] << mGuess.mCode[i];
+        out << (qint32) mGuess.mBlacks << (qint32) mGuess.mWhites << (qint32) mGuess.mPossibles << mGuess.mWeight;
+
+        writeBoxes(out, mCodeBoxes);
+        writeBoxes(out, mMasterBoxes);
+        foreach (PinBox* box, mPinBoxes) {
+            int blacks, whites;
+            box->getValue(blacks, whites);
+            out << (quint8) blacks << (quint8) whites << (quint8) box->getState();
+        }
+        // the human plays against no solver
+        out << ((mode() == Mode::MVH && mSolver) ? mSolver->saveState() : QByteArray());
+        saved = (out.status() == QDataStream::Ok);
+    }
+    if (!saved && mode() == Mode::MVH && mState == State::Thinking)
+        getNextGuess();
+    return saved;
+}
+
+bool Game::resume()
+{
+    QFile file(dataFileName("qtmind.save"));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    quint8 game_mode, colors, pegs, same_colors, game_algorithm, engine, game_state, moves_played;
+    in >> magic >> version;
+    in >> game_mode >> colors >> pegs >> same_colors >> game_algorithm >> engine >> game_state >> moves_played;
+    if (in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION ||
+            colors < MIN_COLOR_NUMBER || colors > MAX_COLOR_NUMBER ||
+            pegs < MIN_SLOT_NUMBER || pegs > MAX_SLOT_NUMBER || (!same_colors && pegs > colors) ||
+            moves_played >= MAX_COLOR_NUMBER || game_mode > (quint8) Mode::HVM ||
+            game_algorithm > (quint8) Algorithm::OPTIMAL || engine > (quint8) Engine::AUTO ||
+            game_state > (quint8) State::WaittingDoneButtonPress) {
+        file.remove();
+        return false;
+    }
+
+    mMode = (Mode) game_mode;
+    mColors = colors;
+    mPegs = pegs;
+    mSameColors = same_colors;
+    mEngine = (Engine) engine;
+    stop();
+    mGuess.reset((Algorithm) game_algorithm, 0);
+    prewarm();
+
+    // the saved game is rejected as a whole if a color or a state is out of range
+    bool valid = true;
+    for(int i = 0; i < MAX_SLOT_NUMBER; ++i) {
+        in >> mGuess.mGuess[i] >> mGuess.mCode[i];
+        if (i < pegs && (mGuess.mGuess[i] >= colors || mGuess.mCode[i] >= colors))
+            valid = false;
+    }
+    qint32 blacks, whites, possibles;
+    in >> blacks >> whites >> possibles >> mGuess.mWeight;
+    mGuess.mBlacks = blacks;
+    mGuess.mWhites = whites;
+    mGuess.mPossibles = possibles;
+
+    valid = valid && readBoxes(in, mCodeBoxes, colors, this) && readBoxes(in, mMasterBoxes, colors, this);
+    foreach (PinBox* box, mPinBoxes) {
+        quint8 box_blacks, box_whites, box_state;
+        in >> box_blacks >> box_whites >> box_state;
+        if (!valid || box_state > (quint8) Box::State::NONE) {
+            valid = false;
+            break;
+        }
+        if (box_blacks + box_whites <= mPegs)
+            box->setPins(box_blacks, box_whites);
+        box->setState((Box::State) box_state);
+    }
+    QByteArray solver_state;
+    in >> solver_state;
+
+    mMovesPlayed = moves_played;
+    valid = valid && (in.status() == QDataStream::Ok);
+    if (valid && mode() == Mode::MVH) {
+        // the game goes on from the state of the solver, which is needed at once
+        createSolver();
+        valid = mSolver->restoreState(solver_state);
+        mSolverReady = valid;
+    }
+    // the saved game is resumed once
+    file.remove();
+    if (!valid) {
+        stop();
+        return false;
+    }
+
+    mState = (State) game_state;
+    if (mode() == Mode::MVH) {
+        // the next turns belong to the last game of the record
+        mRecord->resumeGame(mPegs);
+        setStateOfList(&mPegBoxes, Box::State::FUTURE);
+        if (mState == State::WaittingOkButtonPress) {
+            waitForResponse();
+        } else {
+            // the solver was interupted, it starts over
+            getNextGuess();
+        }
+    } else {
+        setNextRowInAction();
+        mOkButton->setPos(mPinBoxes.at(mMovesPlayed)->pos() + QPoint(0, 1));
+        if ((State) game_state == State::WaittingPinboxPress) {
+            mState = State::WaittingPinboxPress;
+            mOkButton->setEnabled(true);
+            mOkButton->setVisible(true);
+        }
+    }
+    showMessage();
+    showInformation();
+    return true;
+}
+
+QString Game::dataFileName(const QString& name)
+{
+    // the ini format, so that the directory is a real one on every platform
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    return QFileInfo(settings.fileName()).absolutePath() + "/" + name;
+}
+
 void Game::playMVH()
 {
     mDoneButton->setZValue(2);
     mDoneButton->setVisible(false);
     mDoneButton->setEnabled(true);
 
-    if (!mSolver) {
-        mSolver = new Solver(&mGuess, this);
-        connect(mSolver, SIGNAL(guessDoneSignal()), this, SLOT(onGuessReady()));
-
-    }
-    mSolver->interupt();
-    mGuess.reset(algorithm(), mSolver->reset(colors(), pegs(), isSameColors()));
+    // the solver is not needed before the hidden code is done, so that the
+    // first frame does not wait for its tables
+    mGuess.reset(algorithm(), CodeTables::count(colors(), pegs(), isSameColors()));
+    if (mFirstFrameShown)
+        prepareSolver();
 
     mState = State::WaittingHiddenCodeFill;
     showMessage();
@@ -543,6 +862,29 @@ void Game::playMVH()
      */
 }
 
+void Game::createSolver()
+{
+    if (mSolver)
+        return;
+    mSolver = new Solver(&mGuess, this);
+    connect(mSolver, SIGNAL(guessDoneSignal()), this, SLOT(onGuessReady()));
+    connect(mSolver, SIGNAL(locatingDoneSignal()), this, SLOT(onLocatingDone()));
+}
+
+void Game::prepareSolver()
+{
+    TRACE_SCOPE("Game::prepareSolver", "game");
+    if (mode() != Mode::MVH || mSolverReady)
+        return;
+    createSolver();
+    mSolver->interupt();
+    mSolver->wait();
+    mGuess.mPossibles = mSolver->reset(colors(), pegs(), isSameColors());
+    mSolverReady = true;
+    // the limits of the solver may be calibrated since it was shown
+    showInformation();
+}
+
 void Game::playHVM()
 {
     qsrand(time(NULL));
@@ -580,32 +922,46 @@ void Game::showInformation()
     int& possibles = mGuess.mPossibles;
     qreal& weight = mGuess.mWeight;
     if (mode() == Mode::MVH) {
+        QString information;
         if (possibles == 1)
         {
-            mInformation->setText(tr("The Code Is Cracked!"));
-        } else if (possibles > 10000) {
-            mInformation->setText(QString("%1    %2: %3").arg(tr("Random Guess")).
-                                  arg(tr("Remaining")).arg(mTools->mLocale.toString(possibles)));
+            information = tr("The Code Is Cracked!");
+        } else if (possibles > (mSolverReady ? mSolver->exactLimit() : Solver::calibration().exactLimit)) {
+            information = QString("%1    %2: %3").arg(tr("Random Guess")).
+                          arg(tr("Remaining")).arg(mTools->mLocale.toString(possibles));
         } else {
             switch (mGuess.mAlgorithm) {
             case Algorithm::MOST_PARTS:
-                mInformation->setText(QString("%1: %2    %3: %4").arg(tr("Most Parts")).
-                                      arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
-                                      arg(mTools->mLocale.toString(possibles)));
+                information = QString("%1: %2    %3: %4").arg(tr("Most Parts")).
+                              arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
+                              arg(mTools->mLocale.toString(possibles));
                 break;
             case Algorithm::WORST_CASE:
-                mInformation->setText(QString("%1: %2    %3: %4").arg(tr("Worst Case")).
-                                      arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
-                                      arg(mTools->mLocale.toString(possibles)));
+                information = QString("%1: %2    %3: %4").arg(tr("Worst Case")).
+                              arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
+                              arg(mTools->mLocale.toString(possibles));
+                break;
+            case Algorithm::ENTROPY:
+                information = QString("%1: %2    %3: %4").arg(tr("Entropy")).
+                              arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
+                              arg(mTools->mLocale.toString(possibles));
+                break;
+            case Algorithm::OPTIMAL:
+                information = QString("%1    %2: %3").arg(tr("Optimal")).
+                              arg(tr("Remaining")).arg(mTools->mLocale.toString(possibles));
                 break;
             default:
-                mInformation->setText(QString("%1: %2    %3: %4").arg(tr("Expected Size")).
-                                      arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
-                                      arg(mTools->mLocale.toString(possibles)));
+                information = QString("%1: %2    %3: %4").arg(tr("Expected Size")).
+                              arg(mTools->mLocale.toString(weight)).arg(tr("Remaining")).
+                              arg(mTools->mLocale.toString(possibles));
                 break;
             }
 
         }
+        // the cost of the last guess, for the slow turns on some boards
+        if (Solver::hasMetrics() && mSolverReady && mState != State::Thinking)
+            information += QChar(QChar::LineSeparator) + metricsInformation();
+        mInformation->setText(information);
     } else {
         mInformation->setText(QString("%1: %2   %3: %4   %5: %6").arg(tr("Slots", "", pegs())).
                               arg(mTools->mLocale.toString(pegs())).arg(tr("Colors", "", colors())).
@@ -614,6 +970,20 @@ void Game::showInformation()
     }
 }
 
+QString Game::metricsInformation() const
+{
+    const Solver::Metrics metrics = mSolver->metrics();
+    const QLocale& locale = mTools->mLocale;
+    return QString("%1: %2 (-%3)   %4: %5   %6/s   %7: %8 + %9 + %10 ms").
+            arg(tr("Candidates")).arg(locale.toString(metrics.candidates)).
+            arg(locale.toString(metrics.prunedCandidates)).
+            arg(tr("Comparisons")).arg(locale.toString(metrics.comparisons)).
+            arg(locale.toString(metrics.comparisonsPerSecond(), 'g', 3)).arg(tr("Time")).
+            arg(locale.toString(metrics.filterTime/1000.0, 'f', 1)).
+            arg(locale.toString((metrics.reduceTime + metrics.scoreTime)/1000.0, 'f', 1)).
+            arg(locale.toString(metrics.lookAheadTime/1000.0, 'f', 1));
+}
+
 void Game::setTools(Tools* tools)
 {
     mTools = tools;
@@ -639,6 +1009,11 @@ Algorithm Game::algorithm() const
     return mGuess.mAlgorithm;
 }
 
+Engine Game::engine() const
+{
+    return mEngine;
+}
+
 Mode Game::mode() const
 {
     return mMode;
@@ -649,6 +1024,11 @@ void Game::setAlgorithm(const Algorithm &algorithm)
     mGuess.mAlgorithm = algorithm;
 }
 
+void Game::setEngine(const Engine &engine)
+{
+    mEngine = engine;
+}
+
 void Game::setColors(const int &colors)
 {
     mColors = colors;
@@ -705,8 +1085,19 @@ void Game::showMessage()
         break;
     }
 }
+void Game::paintEvent(QPaintEvent* event)
+{
+    TRACE_SCOPE("Game::paintEvent", "game");
+    QGraphicsView::paintEvent(event);
+    if (!mFirstFrameShown) {
+        mFirstFrameShown = true;
+        emit firstFrameSignal();
+    }
+}
+
 void Game::drawBackground(QPainter* painter, const QRectF& rect)
 {
+    TRACE_SCOPE("Game::drawBackground", "paint");
     painter->fillRect(rect, QColor(200, 200, 200));// set scene background color
     painter->setPen(Qt::NoPen);
 
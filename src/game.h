@@ -21,6 +21,7 @@
 #define GAME_H
 
 #include <QGraphicsView>
+#include <QElapsedTimer>
 #include "appinfo.h"
 #include "guess.h"
 #include "ipegconnector.h"
@@ -30,6 +31,8 @@ class PinBox;
 class PegBox;
 class Button;
 class Solver;
+class Prewarmer;
+class GameRecord;
 class Message;
 class QLocale;
 class Tools;
@@ -64,6 +67,19 @@ public:
      */
     void stop();
 
+    /**
+     * @brief save save the unfinished game, with the state of the solver, to
+     * be resumed on the next start
+     * @return true if the game is saved, false otherwise
+     */
+    bool save();
+
+    /**
+     * @brief resume resume the saved game, the saved game is then removed
+     * @return true if a saved game is resumed, false otherwise
+     */
+    bool resume();
+
     /**
     * @brief retranslateTexts retranslate the game
     */
@@ -79,14 +95,23 @@ public:
      * @param tools the tools to be set
      */
     void setTools(Tools* tools);
+    /**
+     * @brief prepareSolver create the solver and reset it for the current
+     * configuration, if it is not yet. A new game of the machine does not
+     * prepare it before the first frame, it is prepared after it or when the
+     * hidden code is done.
+     */
+    void prepareSolver();
 
     int colors() const;
     int pegs() const;
     bool isSameColors() const;
     Algorithm algorithm() const;
+    Engine engine() const;
     Mode mode() const;
 
     void setAlgorithm(const Algorithm& algorithm);
+    void setEngine(const Engine& engine);
     void setColors(const int& colors);
     void setPegs(const int& pegs);
     void setMode(const Mode& mode);
@@ -103,6 +128,14 @@ public slots:
      * to change their font
      */
     void onFontChanged();
+    /**
+     * @brief onUndo take back the last response of the human
+     */
+    void onUndo();
+    /**
+     * @brief onRedo put back the last undone response
+     */
+    void onRedo();
 
 protected:
     /**
@@ -111,6 +144,11 @@ protected:
      * @param rect
          */
     void drawBackground(QPainter* painter, const QRectF& rect);
+    /**
+     * @brief paintEvent paint the view, traced as a paint pass
+     * @param event
+     */
+    void paintEvent(QPaintEvent* event);
     /**
      * @brief resizeEvent
      * @param event
@@ -140,6 +178,10 @@ signals:
      * @param fontSize the font size
      */
     void fontChangedSignal(const QString& fontName, const int& fontSize);
+    /**
+     * @brief firstFrameSignal notify that the first frame of the board is painted
+     */
+    void firstFrameSignal();
 
 protected slots:
     void onPegMouseReleased(Peg*);
@@ -149,6 +191,7 @@ protected slots:
     void onRevealOnePeg();
     void onResigned();
     void onGuessReady();
+    void onLocatingDone();
 
 private:
 
@@ -175,16 +218,46 @@ private:
 
     void playMVH();
     void playHVM();
+    /**
+     * @brief createSolver create the solver, which loads the opening book and
+     * the transposition table, if it is not yet
+     */
+    void createSolver();
+    /**
+     * @brief prewarm build the tables of the current configuration and its
+     * neighbors in the background
+     */
+    void prewarm();
     void createBoxes();
     PegBox* createPegBox(const QPoint& position);
     void codeRowFilled(const bool& filled);
     void showInformation();
+    /**
+     * @brief metricsInformation the candidates, the comparisons and the time of
+     * each phase of the last guess, when the solver counts them
+     * @return QString the line of the metrics
+     */
+    QString metricsInformation() const;
     void showMessage();
     void initializeScene();
     void freezeScene();
     void setNextRowInAction();
     void getNextGuess();
+    /**
+     * @brief responseAccepted go on after the solver accepted the response of the current row
+     */
+    void responseAccepted();
+    /**
+     * @brief waitForResponse let the human put the pins of the guess of the current row
+     */
+    void waitForResponse();
     Player winner() const;
+    /**
+     * @brief dataFileName a file of the game in the settings directory
+     * @param name the name of the file
+     * @return QString the file name
+     */
+    static QString dataFileName(const QString& name);
 
 private:
 
@@ -196,6 +269,13 @@ private:
 
     Game::State mState;              /**< TODO */
     Solver* mSolver;                 /**< TODO */
+    bool mSolverReady;               /**< is the solver reset for the current game? */
+    bool mFirstFrameShown;           /**< is the first frame of the board painted? */
+    Prewarmer* mPrewarmer;           /**< builds the code tables of the coming games in the background */
+    GameRecord* mRecord;             /**< the record of the games that the solver plays */
+    QElapsedTimer mGuessTimer;       /**< times the solver for the current guess */
+    quint32 mGuessElapsed;           /**< the time of the solver for the current guess in microseconds */
+    QElapsedTimer mResponseTimer;    /**< times from the OK press of a response to the next guess on the board */
     Button* mOkButton;               /**< TODO */
     Button* mDoneButton;             /**< TODO */
     Message* mMessage;               /**< TODO */
@@ -203,10 +283,13 @@ private:
     int mMovesPlayed;                /**< TODO */
     Guess mGuess;
     Mode mMode;
+    Engine mEngine;
     bool mSameColors;
     int mPegs;
     int mColors;
     Tools* mTools;
+
+    friend class GuiBenchmark;
 };
 
 #endif // GAME_H
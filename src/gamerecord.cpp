@@ -0,0 +1,167 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "gamerecord.h"
+#include <QDataStream>
+#include <cstring>
+
+static const int HEADER_SIZE = 8; /**< The size of the record header */
+static const qint64 MAX_SIZE = 4*1024*1024; /**< The size above which the record is rotated at open */
+
+GameRecord::GameRecord():
+    mPegs(0)
+{
+}
+
+bool GameRecord::open(const QString& file_name)
+{
+    if (mFile.isOpen())
+        mFile.close();
+    mPegs = 0;
+
+    // the older games are kept in one more file, so that the record stays bounded
+    if (QFile(file_name).size() > MAX_SIZE) {
+        QFile::remove(file_name + ".1");
+        QFile::rename(file_name, file_name + ".1");
+    }
+
+    mFile.setFileName(file_name);
+    if (!mFile.open(QIODevice::ReadWrite | QIODevice::Append))
+        return false;
+
+    if (mFile.size() == 0) {
+        QByteArray header;
+        QDataStream out(&header, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.writeRawData("QMGR", 4);
+        out << (quint16) VERSION << (quint16) 0;
+        append(header);
+    } else {
+        // an unknown file is never appended to
+        mFile.seek(0);
+        QByteArray header = mFile.read(HEADER_SIZE);
+        if (header.size() < HEADER_SIZE || memcmp(header.constData(), "QMGR", 4) != 0 ||
+                (quint8) header.at(4) + ((quint8) header.at(5) << 8) != VERSION) {
+            mFile.close();
+            return false;
+        }
+        mFile.seek(mFile.size());
+    }
+    return mFile.isOpen();
+}
+
+void GameRecord::beginGame(const int& colors, const int& pegs, const bool& same_colors,
+                           const Algorithm& algorithm, const Engine& engine, const unsigned char* secret)
+{
+    mPegs = pegs;
+    QByteArray game;
+    game.append('G');
+    game.append((char) colors);
+    game.append((char) pegs);
+    game.append((char) same_colors);
+    game.append((char) algorithm);
+    game.append((char) engine);
+    game.append(reinterpret_cast<const char*>(secret), pegs);
+    append(game);
+}
+
+void GameRecord::resumeGame(const int& pegs)
+{
+    // the game is not in a rotated or a new file, its turns would have no game
+    if (mFile.isOpen() && mFile.size() > HEADER_SIZE)
+        mPegs = pegs;
+}
+
+void GameRecord::addTurn(const unsigned char* guess, const int& blacks, const int& whites, const quint32& elapsed)
+{
+    if (!mPegs)
+        return;
+    QByteArray turn;
+    QDataStream out(&turn, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << (quint8) 'T';
+    out.writeRawData(reinterpret_cast<const char*>(guess), mPegs);
+    out << (quint8) ((blacks + whites)*(blacks + whites + 1)/2 + blacks) << elapsed;
+    append(turn);
+}
+
+void GameRecord::undoTurn()
+{
+    if (mPegs)
+        append(QByteArray(1, 'U'));
+}
+
+bool GameRecord::read(const QString& file_name, QList<Entry>* entries)
+{
+    QFile file(file_name);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray content = file.readAll();
+    const uchar* data = reinterpret_cast<const uchar*>(content.constData());
+    const int size = content.size();
+    if (size < HEADER_SIZE || memcmp(data, "QMGR", 4) != 0 || data[4] + (data[5] << 8) != VERSION)
+        return false;
+
+    int offset = HEADER_SIZE;
+    while (offset < size) {
+        if (data[offset] == 'G') {
+            if (offset + 6 > size || data[offset + 2] < MIN_SLOT_NUMBER || data[offset + 2] > MAX_SLOT_NUMBER ||
+                    offset + 6 + data[offset + 2] > size)
+                break;
+            Entry entry;
+            entry.colors = data[offset + 1];
+            entry.pegs = data[offset + 2];
+            entry.sameColors = data[offset + 3];
+            entry.algorithm = (Algorithm) data[offset + 4];
+            entry.engine = (Engine) data[offset + 5];
+            memcpy(entry.secret, data + offset + 6, entry.pegs);
+            entries->append(entry);
+            offset += 6 + entry.pegs;
+        } else if (data[offset] == 'T' && !entries->isEmpty()) {
+            Entry& entry = entries->last();
+            if (offset + 1 + entry.pegs + 5 > size)
+                break;
+            Turn turn;
+            memcpy(turn.guess, data + offset + 1, entry.pegs);
+            offset += 1 + entry.pegs;
+            turn.response = data[offset];
+            turn.elapsed = data[offset + 1] | (data[offset + 2] << 8) | (data[offset + 3] << 16) |
+                    ((quint32) data[offset + 4] << 24);
+            offset += 5;
+            entry.turns.append(turn);
+        } else if (data[offset] == 'U' && !entries->isEmpty()) {
+            if (!entries->last().turns.isEmpty())
+                entries->last().turns.removeLast();
+            ++offset;
+        } else {
+            // a damaged file, the games before are kept
+            break;
+        }
+    }
+    return true;
+}
+
+void GameRecord::append(const QByteArray& data)
+{
+    if (!mFile.isOpen())
+        return;
+    // a failed write stops the record, so that nothing follows a broken part
+    if (mFile.write(data) != data.size() || !mFile.flush())
+        mFile.close();
+}
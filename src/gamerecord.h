@@ -0,0 +1,137 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <QFile>
+#include <QList>
+#include <QVector>
+#include "appinfo.h"
+
+/**    @brief The class GameRecord appends the games that the solver plays to a
+ *    binary file, turn by turn, so that the real games can be replayed later.
+ *    The file is only appended to, a game that is not finished, because the
+ *    application is closed or crashed, has the turns that are already written.
+ *    All the numbers are little endian:
+ *
+ *    header:     "QMGR", quint16 version, two reserved bytes
+ *
+ *    game:       'G', quint8 colors, pegs, same colors, algorithm, engine,
+ *                the secret code, one byte for each peg
+ *
+ *    turn:       'T', the guess, one byte for each peg, quint8 response index,
+ *                quint32 time of the solver for the guess in microseconds, 0 if
+ *                the guess was not timed
+ *
+ *    undo:       'U', the last turn of the game is taken back
+ *
+ *    The turns and the undos belong to the last game before them. The response
+ *    index of b blacks and w whites is (b + w)(b + w + 1)/2 + b.
+ *
+ *    A record above 4 MB, some fifty thousand games, is renamed to the same
+ *    name with ".1" when it is opened, over the older one, and a new record is
+ *    started. The games of the two files are at most about 8 MB.
+ */
+class GameRecord
+{
+public:
+
+    /**
+    * @brief The Turn struct
+    * A guess of the solver and the response to it
+    */
+    struct Turn {
+        unsigned char guess[MAX_SLOT_NUMBER];
+        int response; /**< the response index */
+        quint32 elapsed; /**< the time of the solver in microseconds, 0 if unknown */
+    };
+
+    /**
+    * @brief The Entry struct
+    * A recorded game
+    */
+    struct Entry {
+        int colors;
+        int pegs;
+        bool sameColors;
+        Algorithm algorithm;
+        Engine engine;
+        unsigned char secret[MAX_SLOT_NUMBER];
+        QVector<Turn> turns;
+    };
+
+    static const quint16 VERSION = 1; /**< the version of the record format */
+
+    GameRecord();
+
+    /**
+     * @brief open open a record file for appending, the file is created if it
+     * does not exist, and rotated if it is above the limit
+     * @param file_name the record file
+     * @return true if the file is a record, false otherwise
+     */
+    bool open(const QString& file_name);
+
+    /**
+     * @brief beginGame append a new game
+     * @param secret the secret code
+     */
+    void beginGame(const int& colors, const int& pegs, const bool& same_colors,
+                   const Algorithm& algorithm, const Engine& engine, const unsigned char* secret);
+
+    /**
+     * @brief resumeGame go on with the last game of the file, after the
+     * application is restarted. A game of a rotated record is not gone on with
+     */
+    void resumeGame(const int& pegs);
+
+    /**
+     * @brief addTurn append a turn to the last game
+     * @param guess the guess of the solver
+     * @param elapsed the time of the solver in microseconds, 0 if unknown
+     */
+    void addTurn(const unsigned char* guess, const int& blacks, const int& whites, const quint32& elapsed);
+
+    /**
+     * @brief undoTurn take back the last turn of the last game
+     */
+    void undoTurn();
+
+    /**
+     * @brief read read all the games of a record file, the truncated end of a
+     * file is ignored
+     * @param file_name the record file
+     * @param entries the games
+     * @return true if the file is a record, false otherwise
+     */
+    static bool read(const QString& file_name, QList<Entry>* entries);
+
+private:
+    /**
+     * @brief append write a part of the record and flush it to the file
+     */
+    void append(const QByteArray& data);
+
+private:
+    QFile mFile; /**< the record file */
+    int mPegs; /**< the number of pegs of the last game */
+};
+
+#endif // GAMERECORD_H
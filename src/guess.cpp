@@ -19,18 +19,11 @@
 
 #include "guess.h"
 #include <QDebug>
-#include <QSettings>
 
 Guess::Guess()
 {
-    QSettings settings;
-    mAlgorithm = (Algorithm) settings.value("Algorithm", 0).toInt();
-}
-
-Guess::~Guess()
-{
-    QSettings settings;
-    settings.setValue("Algorithm", (int) mAlgorithm);
+    // the game keeps the algorithm in the settings, the tools play without them
+    reset(Algorithm::MOST_PARTS, 0);
 }
 
 void Guess::update(const int& b, const int& w, const int& p)
@@ -58,7 +51,7 @@ void Guess::setWeight(const qreal &weight)
     mWeight = weight;
 }
 
-void Guess::setGuess(const int &pegs, const int &colors, unsigned char* guess)
+void Guess::setGuess(const int &pegs, const int &colors, const unsigned char* guess)
 {
     for(int i = 0; i < pegs; i++)
         mGuess[i] = guess[i];
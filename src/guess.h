@@ -57,14 +57,13 @@ class Guess
 public:
 
     explicit Guess();
-    ~Guess();
 
 public:
     /**
      * @brief setGuess set the guess
      * @param _guess the guesss
      */
-    void setGuess(const int& pegs, const int& colors, unsigned char* guess);
+    void setGuess(const int& pegs, const int& colors, const unsigned char* guess);
     /**
      * @brief setCode set the code
      * @param _code the code
@@ -90,6 +89,11 @@ public:
      * @param weight the new weight
      */
     void setWeight(const qreal& weight);
+    /**
+     * @brief guess the current guess
+     * @return the guess, pegs colors
+     */
+    const unsigned char* guess() const {return mGuess;}
 private:
     unsigned char mGuess[MAX_SLOT_NUMBER]; /**< TODO */
     unsigned char mCode[MAX_SLOT_NUMBER]; /**< TODO */
@@ -0,0 +1,119 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "latencyhistogram.h"
+#include <QDataStream>
+#include <QtCore/qmath.h>
+
+static const qint64 MAX_VALUE = Q_INT64_C(1) << 40; /**< The largest latency counted, longer ones are clamped */
+
+LatencyHistogram::LatencyHistogram():
+    mCount(0),
+    mMax(0)
+{
+}
+
+void LatencyHistogram::record(const qint64& value)
+{
+    const qint64 latency = qBound(Q_INT64_C(0), value, MAX_VALUE);
+    const int index = bucket(latency);
+    if (index >= mCounts.size())
+        mCounts.resize(index + 1);
+    ++mCounts[index];
+    ++mCount;
+    mMax = qMax(mMax, latency);
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other)
+{
+    if (other.mCounts.size() > mCounts.size())
+        mCounts.resize(other.mCounts.size());
+    for(int i = 0; i < other.mCounts.size(); ++i)
+        mCounts[i] += other.mCounts.at(i);
+    mCount += other.mCount;
+    mMax = qMax(mMax, other.mMax);
+}
+
+qint64 LatencyHistogram::percentile(const qreal& percent) const
+{
+    if (mCount == 0)
+        return 0;
+    // the rank of the latency, from 1 to the count
+    const qint64 rank = qBound(Q_INT64_C(1), (qint64) qCeil(percent*mCount/100), mCount);
+    qint64 seen = 0;
+    for(int i = 0; i < mCounts.size(); ++i) {
+        seen += mCounts.at(i);
+        if (seen >= rank)
+            return qMin(highestValue(i), mMax);
+    }
+    return mMax;
+}
+
+int LatencyHistogram::bucket(const qint64& value)
+{
+    if (value < 2*SUB_BUCKETS)
+        return value;
+    // the shift that brings the value to [SUB_BUCKETS, 2*SUB_BUCKETS)
+    int shift = 0;
+    while ((value >> shift) >= 2*SUB_BUCKETS)
+        ++shift;
+    return SUB_BUCKETS*shift + (value >> shift);
+}
+
+qint64 LatencyHistogram::highestValue(const int& bucket)
+{
+    if (bucket < 2*SUB_BUCKETS)
+        return bucket;
+    const int shift = bucket/SUB_BUCKETS - 1;
+    const qint64 sub_bucket = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+QDataStream& operator<<(QDataStream& out, const LatencyHistogram& histogram)
+{
+    // only the used buckets, most are empty
+    quint32 used = 0;
+    foreach(quint32 count, histogram.mCounts)
+        used += (count > 0);
+    out << histogram.mCount << histogram.mMax << used;
+    for(int i = 0; i < histogram.mCounts.size(); ++i)
+        if (histogram.mCounts.at(i) > 0)
+            out << (quint16) i << histogram.mCounts.at(i);
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, LatencyHistogram& histogram)
+{
+    histogram = LatencyHistogram();
+    quint32 used;
+    in >> histogram.mCount >> histogram.mMax >> used;
+    for(quint32 i = 0; i < used && in.status() == QDataStream::Ok; ++i) {
+        quint16 index;
+        quint32 count;
+        in >> index >> count;
+        if (index >= LatencyHistogram::bucket(MAX_VALUE) + 1) {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        if (index >= histogram.mCounts.size())
+            histogram.mCounts.resize(index + 1);
+        histogram.mCounts[index] = count;
+    }
+    return in;
+}
@@ -0,0 +1,79 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+
+class QDataStream;
+
+/**    @brief The class LatencyHistogram counts latencies in microseconds with a
+ *    bounded relative error, as an HDR histogram does. The values under 64 are
+ *    counted exactly, and each power of two above is split into 32 buckets, so
+ *    a percentile is at most about 3% above the real one, for any latency from
+ *    a microsecond to days, in a few kilobytes.
+ */
+class LatencyHistogram
+{
+public:
+
+    static const int SUB_BUCKETS = 32; /**< the buckets of each power of two */
+
+    LatencyHistogram();
+
+    /**
+     * @brief record count a latency
+     * @param value the latency in microseconds, the negative ones count as zero
+     */
+    void record(const qint64& value);
+    /**
+     * @brief add count all the latencies of another histogram
+     */
+    void add(const LatencyHistogram& other);
+    qint64 count() const {return mCount;}
+    qint64 max() const {return mMax;}
+    /**
+     * @brief percentile the latency that the given percent of the latencies do
+     * not exceed, up to the resolution of the buckets
+     * @param percent the percent, from 0 to 100
+     * @return qint64 the latency in microseconds, 0 if nothing is counted
+     */
+    qint64 percentile(const qreal& percent) const;
+
+    friend QDataStream& operator<<(QDataStream& out, const LatencyHistogram& histogram);
+    friend QDataStream& operator>>(QDataStream& in, LatencyHistogram& histogram);
+
+private:
+    /**
+     * @brief bucket the bucket of a latency
+     */
+    static int bucket(const qint64& value);
+    /**
+     * @brief highestValue the largest latency of a bucket
+     */
+    static qint64 highestValue(const int& bucket);
+
+private:
+    QVector<quint32> mCounts; /**< the count of each bucket, grown on demand */
+    qint64 mCount; /**< the number of latencies */
+    qint64 mMax; /**< the largest latency */
+};
+
+#endif // LATENCYHISTOGRAM_H
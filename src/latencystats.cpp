@@ -0,0 +1,156 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "latencystats.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStringList>
+#include <algorithm>
+
+static const quint32 MAGIC = 0x514d4c48; /**< "QMLH", the magic number of the histograms file */
+static const quint16 VERSION = 1; /**< the version of the histograms file */
+
+Q_GLOBAL_STATIC(LatencyStats, sLatencyStats)
+
+/*    A key packs the latency kind, the colors, the pegs, the same colors flag,
+ *    the algorithm and the turn, from the high bits to the low ones.
+ */
+static quint32 packKey(const int& latency, const int& colors, const int& pegs, const bool& same_colors,
+                       const int& algorithm, const int& turn)
+{
+    return (latency << 24) | (colors << 16) | (pegs << 12) | (same_colors << 11) | (algorithm << 8) | turn;
+}
+
+LatencyStats::LatencyStats():
+    mChanged(false)
+{
+}
+
+LatencyStats* LatencyStats::instance()
+{
+    LatencyStats* stats = sLatencyStats();
+    static bool loaded = false;
+    if (!loaded) {
+        loaded = true;
+        stats->load();
+    }
+    return stats;
+}
+
+void LatencyStats::record(const Latency& latency, const int& colors, const int& pegs, const bool& same_colors,
+                          const Algorithm& algorithm, const int& turn, const qint64& microseconds)
+{
+    mHistograms[packKey((int) latency, colors, pegs, same_colors, (int) algorithm, qBound(0, turn, 255))].
+            record(microseconds);
+    mChanged = true;
+}
+
+QString LatencyStats::report() const
+{
+    static const char* latency_names[] = {"solver", "response"};
+    static const char* algorithm_names[] = {"most-parts", "worst-case", "expected-size", "entropy", "optimal"};
+
+    QList<quint32> keys = mHistograms.keys();
+    std::sort(keys.begin(), keys.end());
+
+    QString report("latency,colors,pegs,same_colors,algorithm,turn,count,p50_ms,p90_ms,p99_ms,max_ms\n");
+    foreach(quint32 key, keys) {
+        const LatencyHistogram histogram = mHistograms.value(key);
+        const int algorithm = (key >> 8) & 7;
+        QStringList fields;
+        fields << latency_names[(key >> 24) & 1] << QString::number((key >> 16) & 0xff) <<
+                  QString::number((key >> 12) & 0xf) << QString::number((key >> 11) & 1) <<
+                  (algorithm < 5 ? algorithm_names[algorithm] : "unknown") << QString::number(key & 0xff) <<
+                  QString::number(histogram.count());
+        foreach(qreal percent, QList<qreal>() << 50 << 90 << 99)
+            fields << QString::number(histogram.percentile(percent)/1000.0, 'f', 3);
+        fields << QString::number(histogram.max()/1000.0, 'f', 3);
+        report += fields.join(",") + "\n";
+    }
+    return report;
+}
+
+bool LatencyStats::exportReport(const QString& file_name) const
+{
+    QFile file(file_name);
+    const QByteArray csv = report().toUtf8();
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(csv) == csv.size();
+}
+
+bool LatencyStats::load(const QString& file_name)
+{
+    QFile file(file_name.isEmpty() ? defaultFileName() : file_name);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    quint32 size;
+    in >> magic >> version >> size;
+    if (magic != MAGIC || version != VERSION)
+        return false;
+
+    QHash<quint32, LatencyHistogram> histograms;
+    for(quint32 i = 0; i < size && in.status() == QDataStream::Ok; ++i) {
+        quint32 key;
+        LatencyHistogram histogram;
+        in >> key >> histogram;
+        histograms.insert(key, histogram);
+    }
+    // a damaged file is not merged with the new latencies
+    if (in.status() != QDataStream::Ok)
+        return false;
+    mHistograms = histograms;
+    mChanged = false;
+    return true;
+}
+
+bool LatencyStats::save(const QString& file_name)
+{
+    if (!mChanged && file_name.isEmpty())
+        return true;
+
+    QString name = file_name.isEmpty() ? defaultFileName() : file_name;
+    QDir().mkpath(QFileInfo(name).absolutePath());
+    QFile file(name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QDataStream out(&file);
+    out << MAGIC << VERSION << (quint32) mHistograms.size();
+    for(QHash<quint32, LatencyHistogram>::const_iterator it = mHistograms.constBegin(); it != mHistograms.constEnd(); ++it)
+        out << it.key() << it.value();
+    if (out.status() != QDataStream::Ok)
+        return false;
+    mChanged = false;
+    return true;
+}
+
+QString LatencyStats::defaultFileName()
+{
+    // the ini format, so that the directory is a real one on every platform
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    return QFileInfo(settings.fileName()).absolutePath() + "/qtmind.latency";
+}
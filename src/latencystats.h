@@ -0,0 +1,105 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include "appinfo.h"
+#include "latencyhistogram.h"
+#include <QHash>
+#include <QString>
+
+/**    @brief The class LatencyStats keeps the latencies of the real games, across
+ *    sessions, in a histogram for each configuration, algorithm and turn. It
+ *    tells which boards are slow for the players, without anyone having to
+ *    reproduce them. The histograms are saved in the settings directory, and
+ *    exported with their percentiles as CSV.
+ */
+class LatencyStats
+{
+public:
+
+    /**
+     * @brief The Latency enum
+     */
+    enum class Latency {
+        SOLVER, /**< the time of the solver for a guess */
+        RESPONSE /**< from the OK press of a response to its next guess on the board */
+    };
+
+    LatencyStats();
+
+    /**
+     * @brief instance the statistics of the application, loaded from the
+     * settings directory on the first call
+     * @return LatencyStats* the statistics of the application
+     */
+    static LatencyStats* instance();
+
+    /**
+     * @brief record count a latency of a turn
+     * @param latency the kind of the latency
+     * @param colors the number of colors
+     * @param pegs the number of pegs
+     * @param same_colors same color allowed flag
+     * @param algorithm the solving algorithm
+     * @param turn the turn of the guess, from 1
+     * @param microseconds the latency
+     */
+    void record(const Latency& latency, const int& colors, const int& pegs, const bool& same_colors,
+                const Algorithm& algorithm, const int& turn, const qint64& microseconds);
+
+    /**
+     * @brief report the count, p50, p90, p99 and the maximum of each histogram
+     * in milliseconds, a line of comma separated values for each
+     * @return QString the report, with a header line
+     */
+    QString report() const;
+    /**
+     * @brief exportReport write the report to a file
+     * @param file_name the CSV file
+     * @return true if the file is written, false otherwise
+     */
+    bool exportReport(const QString& file_name) const;
+
+    /**
+     * @brief load read the histograms from a file
+     * @param file_name the histograms file, the default one if empty
+     * @return true if the histograms are read, false otherwise
+     */
+    bool load(const QString& file_name = QString());
+    /**
+     * @brief save write the histograms to a file, if they are changed
+     * @param file_name the histograms file, the default one if empty
+     * @return true if the histograms are written, false otherwise
+     */
+    bool save(const QString& file_name = QString());
+
+private:
+    /**
+     * @brief defaultFileName the histograms file in the settings directory
+     */
+    static QString defaultFileName();
+
+private:
+    QHash<quint32, LatencyHistogram> mHistograms; /**< the histograms by their packed keys */
+    bool mChanged; /**< is a latency counted since they are loaded? */
+};
+
+#endif // LATENCYSTATS_H
@@ -19,19 +19,53 @@
 
 #include "mainwindow.h"
 #include "appinfo.h"
+#include "tracer.h"
+#include "startup.h"
 #include <QApplication>
 #include <QSettings>
+#include <QStringList>
+#include <cstdio>
 
 int main(int argc, char *argv[])
 {
+    Startup::start();
     QApplication app(argc, argv);
     app.setApplicationName(APP_NAME);
     app.setApplicationVersion(APP_VER);
     app.setOrganizationName(ORG_NAME);
     app.setOrganizationDomain(ORG_DOMAIN);
 
-    MainWindow w; // MainWindow will delete game
-    w.setWindowIcon(QIcon("://icons/resources/icons/qtmind.png"));
-    w.show();
-    return app.exec();
+    // --trace FILE or QTMIND_TRACE=FILE writes a Chrome trace of the solver and the game
+    QString trace_file = QString::fromLocal8Bit(qgetenv("QTMIND_TRACE"));
+    const int trace_index = app.arguments().indexOf("--trace");
+    if (trace_index > 0 && trace_index + 1 < app.arguments().size())
+        trace_file = app.arguments().at(trace_index + 1);
+    if (!trace_file.isEmpty()) {
+        Tracer::start(trace_file);
+        Tracer::setThreadName("GUI");
+    }
+
+    // --startup-benchmark closes the window after the start, and reports its times
+    const bool startup_benchmark = app.arguments().contains("--startup-benchmark");
+
+    int result;
+    {
+        MainWindow w; // MainWindow will delete game
+        w.setWindowIcon(QIcon("://icons/resources/icons/qtmind.png"));
+        if (startup_benchmark)
+            QObject::connect(&w, SIGNAL(startupDone()), &w, SLOT(close()), Qt::QueuedConnection);
+        w.show();
+        result = app.exec();
+    }
+    // the window is closed first, so that the trace has the whole session
+    if (!Tracer::stop())
+        qWarning("could not write the trace file %s", qPrintable(trace_file));
+    if (startup_benchmark) {
+        printf("{\"firstFrameMs\": %lld, \"deferredMs\": %lld, \"budgetMs\": %d, \"withinBudget\": %s}\n",
+               Startup::firstFrame(), Startup::deferred(), Startup::budget(),
+               Startup::isWithinBudget() ? "true" : "false");
+        if (!Startup::isWithinBudget())
+            result = 1;
+    }
+    return result;
 }
@@ -24,6 +24,8 @@
 #include "appinfo.h"
 #include "tools.h"
 #include "peg.h"
+#include "startup.h"
+#include "tracer.h"
 #include <QComboBox>
 #include <QMessageBox>
 #include <QSettings>
@@ -35,6 +37,8 @@
 #include <QDir>
 #include <QTranslator>
 #include <QCloseEvent>
+#include <QTimer>
+#include <QtConcurrentRun>
 
 #ifdef Q_OS_ANDROID
 const bool MainWindow::sIsAndroid = true;
@@ -46,12 +50,18 @@ MainWindow::MainWindow(QWidget* parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow)
 {
+    TRACE_SCOPE("MainWindow::MainWindow", "game");
     ui->setupUi(this);
     mGame.setTools(&mTools);
+    connect(&mGame, SIGNAL(firstFrameSignal()), this, SLOT(onFirstFrame()));
+    connect(&mCalibration, SIGNAL(finished()), this, SLOT(onCalibrated()));
 
     loadTranslation();
     QApplication::setLayoutDirection(mTools.mLocale.textDirection());
 
+    // the unfinished game of the last run, the widgets are set by its configuration
+    const bool resumed = mGame.resume();
+
     setCentralWidget(&mGame);
 
     auto modeActions = new QActionGroup(this);
@@ -103,22 +113,7 @@ MainWindow::MainWindow(QWidget* parent) :
     ui->actionAuto_Set_Pins->setChecked(mTools.mAutoPutPins);
     ui->actionAuto_Close_Rows->setChecked(mTools.mAutoCloseRows);
 
-    QStringList translations = findTranslations();
-    QString app_name_ = QApplication::applicationName().toLower()+"_";
-    translations = translations.filter(app_name_);
-    auto language_actions = new QActionGroup(this);
-    foreach(QString translation, translations) {
-        translation.remove(app_name_);
-        auto language_act = new QAction(languageName(translation), this);
-        language_act->setData(translation);
-        language_act->setCheckable(true);
-        language_act->setChecked(mTools.mLocale.name().left(2) == translation);
-        language_actions->addAction(language_act);
-        ui->menuLanguage->addAction(language_act);
-    }
-    language_actions->setExclusive(true);
-
-
+    // the language menu is created after the first frame
     mPegsComboBox = new QComboBox(this);
     auto slotActions = new QActionGroup(this);
     for(int i = MIN_SLOT_NUMBER; i <= MAX_SLOT_NUMBER; ++i) {
@@ -153,11 +148,13 @@ MainWindow::MainWindow(QWidget* parent) :
     mAlgorithmsComboBox->addItem(tr("Most Parts"), 0);
     mAlgorithmsComboBox->addItem(tr("Worst Case"), 1);
     mAlgorithmsComboBox->addItem(tr("Expected Size"), 2);
+    mAlgorithmsComboBox->addItem(tr("Entropy"), 3);
+    mAlgorithmsComboBox->addItem(tr("Optimal"), 4);
     mAlgorithmsComboBox->setCurrentIndex((int) mGame.algorithm());
 
     auto algorithmActions = new QActionGroup(this);
-    for(int i = 0; i < 3; i++) {
-        auto alg_act = new QAction((i == 0) ? tr("Most Parts") : ((i == 1) ? tr("Worst Case"): tr("Expected Size")), this);
+    for(int i = 0; i < mAlgorithmsComboBox->count(); i++) {
+        auto alg_act = new QAction(mAlgorithmsComboBox->itemText(i), this);
         alg_act->setCheckable(true);
         alg_act->setData(i);
         alg_act->setChecked(mGame.algorithm() == static_cast<Algorithm>(i));
@@ -166,6 +163,20 @@ MainWindow::MainWindow(QWidget* parent) :
     }
     algorithmActions->setExclusive(true);
 
+    ui->menuAlgorithm->addSeparator();
+    auto engineActions = new QActionGroup(this);
+    QStringList engine_names;
+    engine_names << tr("One Step") << tr("Look Ahead") << tr("Auto");
+    for(int i = 0; i < engine_names.size(); i++) {
+        auto engine_act = new QAction(engine_names.at(i), this);
+        engine_act->setCheckable(true);
+        engine_act->setData(i);
+        engine_act->setChecked(mGame.engine() == static_cast<Engine>(i));
+        engineActions->addAction(engine_act);
+        ui->menuAlgorithm->addAction(engine_act);
+    }
+    engineActions->setExclusive(true);
+
     ui->toolBar->addAction(ui->actionNew);
     ui->toolBar->addAction(ui->actionAllow_Same_Colors);
     ui->toolBar->addSeparator();
@@ -176,6 +187,8 @@ MainWindow::MainWindow(QWidget* parent) :
     connect(ui->actionNew, SIGNAL(triggered()), this, SLOT(onNewGame()));
     connect(ui->actionReveal_One_Peg, SIGNAL(triggered()), &mGame, SLOT(onRevealOnePeg()));
     connect(ui->actionResign, SIGNAL(triggered()), &mGame, SLOT(onResigned()));
+    connect(ui->actionUndo, SIGNAL(triggered()), &mGame, SLOT(onUndo()));
+    connect(ui->actionRedo, SIGNAL(triggered()), &mGame, SLOT(onRedo()));
     connect(ui->actionQuit, SIGNAL(triggered()), this, SLOT(close()));
     connect(modeActions, SIGNAL(triggered(QAction*)), this, SLOT(onModeChanged(QAction*)));
     connect(volumeModeActions, SIGNAL(triggered(QAction*)), this, SLOT(onVolumeChanged(QAction*)));
@@ -183,7 +196,8 @@ MainWindow::MainWindow(QWidget* parent) :
     connect(mColorsComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onColorComboChanged(int)));
     connect(slotActions, SIGNAL(triggered(QAction*)), this, SLOT(onSlotActionChanged(QAction*)));
     connect(mPegsComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onSlotComboChanged(int)));
-    connect(ui->menuAlgorithm, SIGNAL(triggered(QAction*)), this, SLOT(onAlgorithmActionChanged(QAction*)));
+    connect(algorithmActions, SIGNAL(triggered(QAction*)), this, SLOT(onAlgorithmActionChanged(QAction*)));
+    connect(engineActions, SIGNAL(triggered(QAction*)), this, SLOT(onEngineChanged(QAction*)));
     connect(mAlgorithmsComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onAlgorithmComboChanged(int)));
     connect(ui->menuIndicators->actions().at(0), SIGNAL(triggered()), this, SLOT(onIndicatorChanged()));
     connect(ui->menuIndicators->actions().at(1), SIGNAL(triggered()), this, SLOT(onIndicatorChanged()));
@@ -206,7 +220,10 @@ MainWindow::MainWindow(QWidget* parent) :
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(onShowContextMenu(QPoint)));
     connect(indicator_types, SIGNAL(triggered(QAction*)), this, SLOT(onIndicatorTypeChanged(QAction*)));
-    onNewGame();
+    if (resumed)
+        updateGameActions();
+    else
+        onNewGame();
     mGame.onResetIndicators();
 
     retranslate();
@@ -227,6 +244,61 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+void MainWindow::onFirstFrame()
+{
+    Startup::firstFrameShown();
+    // the deferred work comes after the frame is on the screen
+    QTimer::singleShot(0, this, SLOT(onDeferredStartup()));
+}
+
+void MainWindow::onDeferredStartup()
+{
+    TRACE_SCOPE("MainWindow::onDeferredStartup", "game");
+    createLanguageMenu();
+    mSounds.load();
+    /*    The first run calibrates the machine on a worker, so that the window
+     *    stays responsive for the seconds it takes. The solver is prepared
+     *    with the limits after it, a game that starts before keeps the default
+     *    limits until its end.
+     */
+    if (mTools.mCalibrated)
+        finishStartup();
+    else
+        mCalibration.setFuture(QtConcurrent::run(&Solver::calibrate));
+}
+
+void MainWindow::onCalibrated()
+{
+    mTools.setCalibration(mCalibration.result());
+    finishStartup();
+}
+
+void MainWindow::finishStartup()
+{
+    mGame.prepareSolver();
+    Startup::deferredDone();
+    emit startupDone();
+}
+
+void MainWindow::createLanguageMenu()
+{
+    if (!ui->menuLanguage->actions().isEmpty())
+        return;
+    QString app_name_ = QApplication::applicationName().toLower()+"_";
+    QStringList translations = mTranslations.filter(app_name_);
+    auto language_actions = new QActionGroup(this);
+    foreach(QString translation, translations) {
+        translation.remove(app_name_);
+        auto language_act = new QAction(languageName(translation), this);
+        language_act->setData(translation);
+        language_act->setCheckable(true);
+        language_act->setChecked(mTools.mLocale.name().left(2) == translation);
+        language_actions->addAction(language_act);
+        ui->menuLanguage->addAction(language_act);
+    }
+    language_actions->setExclusive(true);
+}
+
 void MainWindow::retranslate()
 {
     setWindowTitle(tr("QtMind"));
@@ -236,8 +308,15 @@ void MainWindow::retranslate()
     ui->menuAlgorithm->actions().at(0)->setText(tr("&Most Parts"));
     ui->menuAlgorithm->actions().at(1)->setText(tr("&Worst Case"));
     ui->menuAlgorithm->actions().at(2)->setText(tr("&Expected Size"));
+    ui->menuAlgorithm->actions().at(3)->setText(tr("E&ntropy"));
+    ui->menuAlgorithm->actions().at(4)->setText(tr("O&ptimal"));
+    ui->menuAlgorithm->actions().at(6)->setText(tr("&One Step"));
+    ui->menuAlgorithm->actions().at(7)->setText(tr("&Look Ahead"));
+    ui->menuAlgorithm->actions().at(8)->setText(tr("A&uto"));
     ui->menuColors->setTitle(tr("&Colors"));
     ui->menuSlots->setTitle(tr("&Slots"));
+    ui->actionUndo->setText(tr("&Undo"));
+    ui->actionRedo->setText(tr("Re&do"));
     ui->actionReveal_One_Peg->setText(tr("Reveal One &Peg"));
     ui->actionResign->setText(tr("&Resign"));
     ui->actionQuit->setText(tr("&Quit"));
@@ -259,7 +338,7 @@ void MainWindow::retranslate()
     ui->menuVolume->actions().at(1)->setText(tr("&Low"));
     ui->menuVolume->actions().at(2)->setText(tr("&Medium"));
     ui->menuVolume->actions().at(3)->setText(tr("&High"));
-    ui->actionFont->setText(tr("&Font"));
+    ui->actionFont->setText(tr("&Preferences"));
 
     ui->menuHelp->setTitle(tr("&Help"));
     ui->actionQtMind_Home_Page->setText(tr("QtMind &Home Page"));
@@ -288,6 +367,8 @@ void MainWindow::retranslate()
     mAlgorithmsComboBox->setItemText(0, tr("Most Parts"));
     mAlgorithmsComboBox->setItemText(1, tr("Worst Case"));
     mAlgorithmsComboBox->setItemText(2, tr("Expected Size"));
+    mAlgorithmsComboBox->setItemText(3, tr("Entropy"));
+    mAlgorithmsComboBox->setItemText(4, tr("Optimal"));
 
     mGame.retranslateTexts();
 }
@@ -299,20 +380,23 @@ void MainWindow::setPegsNumber(const int& pegs_n)
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    if (mGame.isRunning()) {
+    // the unfinished game is saved to be resumed on the next start, if it
+    // can not be saved, it is lost
+    if (mGame.isRunning() && !mGame.save()) {
         int ret = QMessageBox::warning(this, tr("Quit"),
                                        QString(sIsAndroid ? "%1\n%2" : "<p align='center'>%1</p>"
                                                                        "<p align='center'>%2</p>")
                                        .arg(tr("An unfinished game is in progress."))
                                        .arg(tr("Do you want to quit?")),
                                        QMessageBox::Yes | QMessageBox::No);
-        if (ret == QMessageBox::No)
+        if (ret == QMessageBox::No) {
             event->ignore();
-    } else {
-        mGame.stop();
-        QSettings().setValue("Geometry", saveGeometry());
-        QMainWindow::closeEvent(event);
+            return;
+        }
     }
+    mGame.stop();
+    QSettings().setValue("Geometry", saveGeometry());
+    QMainWindow::closeEvent(event);
 }
 
 void MainWindow::onNewGame()
@@ -334,6 +418,12 @@ void MainWindow::onNewGame()
         mGame.setColors(6);
     }
 
+    updateGameActions();
+    mGame.play();
+}
+
+void MainWindow::updateGameActions()
+{
     ui->actionAllow_Same_Colors->setChecked(mGame.isSameColors());
     if (mGame.isSameColors())
         ui->actionAllow_Same_Colors->setToolTip(tr("Same Color Allowed"));
@@ -343,7 +433,11 @@ void MainWindow::onNewGame()
     ui->actionResign->setVisible(mGame.mode() == Mode::HVM);
     ui->actionReveal_One_Peg->setEnabled(mGame.mode() == Mode::HVM);
     ui->actionReveal_One_Peg->setVisible(mGame.mode() == Mode::HVM);
-    mGame.play();
+    // only the responses of the human can be undone
+    ui->actionUndo->setEnabled(mGame.mode() == Mode::MVH);
+    ui->actionUndo->setVisible(mGame.mode() == Mode::MVH);
+    ui->actionRedo->setEnabled(mGame.mode() == Mode::MVH);
+    ui->actionRedo->setVisible(mGame.mode() == Mode::MVH);
 }
 
 bool MainWindow::quitUnfinishedGame()
@@ -363,7 +457,7 @@ void MainWindow::onFontChanged()
 {
     auto preferencesWidget = new Preferences(&mTools, this);
     preferencesWidget->setModal(true);
-    preferencesWidget->setWindowTitle(tr("Font"));
+    preferencesWidget->setWindowTitle(tr("Preferences"));
     connect(preferencesWidget, SIGNAL(fontChangedSignal()), &mGame, SLOT(onFontChanged()));
     preferencesWidget->exec();
 }
@@ -466,6 +560,11 @@ void MainWindow::onAlgorithmComboChanged(const int& combo_index)
     }
 }
 
+void MainWindow::onEngineChanged(QAction *engine_action)
+{
+    mGame.setEngine(static_cast<Engine>(engine_action->data().toInt()));
+}
+
 void MainWindow::onIndicatorTypeChanged(QAction *indic_act)
 {
     Peg::setIndicator(static_cast<Indicator>(indic_act->data().toInt()));
@@ -490,6 +589,8 @@ void MainWindow::onShowContextMenu(const QPoint& position)
     contextMenu.addMenu(ui->menuSlots);
     contextMenu.addMenu(ui->menuColors);
     contextMenu.addMenu(ui->menuAlgorithm);
+    contextMenu.addAction(ui->actionUndo);
+    contextMenu.addAction(ui->actionRedo);
     contextMenu.addAction(ui->actionReveal_One_Peg);
     contextMenu.addAction(ui->actionResign);
     contextMenu.addSeparator();
@@ -532,7 +633,8 @@ void MainWindow::loadTranslation()
 
     // Find current locale
     QString current = mTools.mLocale.name();
-    QStringList translations = findTranslations();
+    mTranslations = findTranslations();
+    const QStringList& translations = mTranslations;
     if (!translations.contains(app_name_ + current)) {
         current = current.left(2);
         if (!translations.contains(app_name_
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "tools.h"
 #include <QLocale>
+#include <QFutureWatcher>
 
 class QComboBox;
 class Sounds;
@@ -48,6 +49,12 @@ public:
     explicit MainWindow(QWidget* parent = 0);
     ~MainWindow();
 
+signals:
+    /**
+     * @brief startupDone notify that the work deferred after the first frame is done
+     */
+    void startupDone();
+
 protected:
     void closeEvent(QCloseEvent* event);
 
@@ -69,14 +76,42 @@ protected slots:
     void onSlotComboChanged(const int& combo_index);
     void onAlgorithmActionChanged(QAction* algorithm_action);
     void onAlgorithmComboChanged(const int& combo_index);
+    void onEngineChanged(QAction* engine_action);
     void onIndicatorTypeChanged(QAction* indic_act);
     void onLanguageChanged(QAction* language_act);
+    /**
+     * @brief onFirstFrame record the time of the first frame, and defer the
+     * rest of the start after it
+     */
+    void onFirstFrame();
+    /**
+     * @brief onDeferredStartup the start that the first frame does not wait for
+     */
+    void onDeferredStartup();
+    /**
+     * @brief onCalibrated keep the limits that the first run measured, and end
+     * the deferred start
+     */
+    void onCalibrated();
 
 private:
     QStringList findTranslations();
     void loadTranslation();
+    /**
+     * @brief createLanguageMenu add the languages of the translations to the menu
+     */
+    void createLanguageMenu();
+    /**
+     * @brief finishStartup prepare the solver with the limits of the machine,
+     * the last of the deferred start
+     */
+    void finishStartup();
     QString languageName(const QString& language);
     bool quitUnfinishedGame();
+    /**
+     * @brief updateGameActions set the actions that depend on the game configuration
+     */
+    void updateGameActions();
     void retranslate();
     void setPegsNumber(const int& pegs_n);
     Mode getMode();
@@ -91,7 +126,9 @@ private:
     Game mGame; /**< TODO */
     Sounds mSounds;
     QString mAppPath; /**< TODO */
+    QStringList mTranslations; /**< the translation files, found once by loadTranslation */
     Tools mTools;
+    QFutureWatcher<Solver::Calibration> mCalibration; /**< the calibration of the first run, off the GUI thread */
 };
 
 #endif // MAINWINDOW_H
@@ -19,6 +19,7 @@
 
 #include "message.h"
 #include "tools.h"
+#include "tracer.h"
 #include <QTextLayout>
 #include <QPainter>
 #include <QFont>
@@ -38,6 +39,7 @@ Message::Message(const QString& fontName, const int& fontSize, const QString& co
 
 void Message::setText(const QString _text)
 {
+    TRACE_SCOPE("Message::setText", "game");
     mText = _text;
     mUpdateRect = boundingRect();
     mTextLayout.setText(mText);
@@ -83,6 +85,7 @@ QRectF Message::boundingRect() const
 
 void Message::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
 {
+    TRACE_SCOPE("Message::paint", "paint");
     painter->setRenderHint(QPainter::TextAntialiasing, true);
     painter->setPen(QPen(mColor));
     float ypos = 4 + (70 - mTextLayout.boundingRect().height()) / 2;
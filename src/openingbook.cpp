@@ -0,0 +1,189 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "openingbook.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QStringList>
+#include <QMutex>
+#include <cstring>
+
+static const int HEADER_SIZE = 8; /**< The size of the book header */
+static const int SECTION_SIZE = 16; /**< The size of a section header */
+
+Q_GLOBAL_STATIC(OpeningBook, sOpeningBook)
+
+OpeningBook::OpeningBook():
+    mData(0),
+    mSize(0)
+{
+}
+
+OpeningBook::~OpeningBook()
+{
+    if (mData && mBuffer.isEmpty())
+        mFile.unmap(const_cast<uchar*>(mData));
+}
+
+OpeningBook* OpeningBook::instance()
+{
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    OpeningBook* book = sOpeningBook();
+    static bool searched = false;
+    if (!searched) {
+        searched = true;
+        QString appdir = QCoreApplication::applicationDirPath();
+        QStringList paths;
+        paths.append("assets:/");// Android
+        paths.append(appdir + "/");// Windows
+        paths.append(appdir + "/../share/" + QCoreApplication::applicationName().toLower() + "/");// *nix
+        paths.append(appdir + "/../Resources/");// Mac
+        foreach(QString path, paths) {
+            if (QFile::exists(path + "qtmind.book") && book->load(path + "qtmind.book"))
+                break;
+        }
+    }
+    return book;
+}
+
+bool OpeningBook::load(const QString& file_name)
+{
+    if (mData && mBuffer.isEmpty())
+        mFile.unmap(const_cast<uchar*>(mData));
+    if (mFile.isOpen())
+        mFile.close();
+    mBuffer.clear();
+    mData = 0;
+    mSize = 0;
+
+    mFile.setFileName(file_name);
+    if (!mFile.open(QIODevice::ReadOnly))
+        return false;
+
+    mSize = mFile.size();
+    mData = mFile.map(0, mSize);
+    if (!mData) {
+        // some files, like the Android assets, can not be mapped
+        mBuffer = mFile.readAll();
+        mData = reinterpret_cast<const uchar*>(mBuffer.constData());
+    }
+
+    if (mSize < HEADER_SIZE || memcmp(mData, "QMOB", 4) != 0 || readNumber(4, 2) != VERSION ||
+            mSize < HEADER_SIZE + SECTION_SIZE*readNumber(6, 2)) {
+        load(QString());
+        return false;
+    }
+    return true;
+}
+
+bool OpeningBook::save(const QString& file_name, const QList<Section>& sections)
+{
+    QFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData("QMOB", 4);
+    out << (quint16) VERSION << (quint16) sections.size();
+
+    quint32 offset = HEADER_SIZE + SECTION_SIZE*sections.size();
+    foreach(const Section& section, sections) {
+        int node_size = 1 + (section.pegs + 1)*(section.pegs + 2)/2;
+        out << section.colors << section.pegs << section.sameColors << section.algorithm
+            << section.engine << section.plies << (quint16) 0
+            << (quint32) (section.nodes.size()/node_size) << offset;
+        offset += 4*section.nodes.size();
+    }
+
+    foreach(const Section& section, sections)
+        foreach(quint32 number, section.nodes)
+            out << number;
+
+    return out.status() == QDataStream::Ok;
+}
+
+bool OpeningBook::hasSection(const int& colors, const int& pegs, const bool& same_colors,
+                             const Algorithm& algorithm, const Engine& engine) const
+{
+    return findSection(colors, pegs, same_colors, algorithm, engine) >= 0;
+}
+
+bool OpeningBook::find(const int& colors, const int& pegs, const bool& same_colors,
+                       const Algorithm& algorithm, const Engine& engine,
+                       const QVector<unsigned char>& guesses, const QVector<int>& responses,
+                       unsigned char* guess) const
+{
+    int section = findSection(colors, pegs, same_colors, algorithm, engine);
+    if (section < 0)
+        return false;
+
+    const int node_size = 4*(1 + (pegs + 1)*(pegs + 2)/2);
+    const quint32 nodes = readNumber(section + 8);
+    const qint64 first_node = readNumber(section + 12);
+    if (first_node + (qint64) nodes*node_size > mSize)
+        return false;
+
+    quint32 node = 0;
+    for(int row = 0; row < responses.size(); ++row) {
+        quint32 key = 0;
+        for(int i = 0; i < pegs; ++i)
+            key = key*colors + guesses.at(row*pegs + i);
+        if (readNumber(first_node + node*node_size) != key)
+            return false;
+
+        node = readNumber(first_node + node*node_size + 4*(1 + responses.at(row)));
+        if (node == 0 || node >= nodes)
+            return false;
+    }
+
+    quint32 key = readNumber(first_node + node*node_size);
+    for(int i = pegs - 1; i >= 0; --i) {
+        guess[i] = key % colors;
+        key /= colors;
+    }
+    return true;
+}
+
+int OpeningBook::findSection(const int& colors, const int& pegs, const bool& same_colors,
+                             const Algorithm& algorithm, const Engine& engine) const
+{
+    if (!mData)
+        return -1;
+
+    int sections = readNumber(6, 2);
+    for(int i = 0; i < sections; ++i) {
+        int offset = HEADER_SIZE + i*SECTION_SIZE;
+        if (mData[offset] == colors && mData[offset + 1] == pegs &&
+                mData[offset + 2] == (same_colors ? 1 : 0) &&
+                mData[offset + 3] == static_cast<int>(algorithm) &&
+                mData[offset + 4] == static_cast<int>(engine))
+            return offset;
+    }
+    return -1;
+}
+
+quint32 OpeningBook::readNumber(const qint64& offset, const int& size) const
+{
+    quint32 number = 0;
+    for(int i = size - 1; i >= 0; --i)
+        number = (number << 8) | mData[offset + i];
+    return number;
+}
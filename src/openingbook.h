@@ -0,0 +1,126 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <QFile>
+#include <QList>
+#include <QVector>
+#include "appinfo.h"
+
+/**    @brief The class OpeningBook holds the first plies of the solver's decision
+ *    trees, one tree for each configuration, algorithm and engine. The book is
+ *    a binary file which is memory mapped and looked up by the game history.
+ *    All the numbers are little endian:
+ *
+ *    header:     "QMOB", quint16 version, quint16 number of sections
+ *
+ *    section:    quint8 colors, pegs, same colors, algorithm, engine, plies,
+ *                two reserved bytes, quint32 number of nodes, quint32 offset
+ *                of the first node from the begining of the file
+ *
+ *    node:       quint32 key of the guess, followed by a quint32 child index for
+ *                each response, 0 if there is no child
+ *
+ *    The first node of a section is the root of its tree, the first guess.
+ *    The key of a code is its value in base colors.
+ */
+class OpeningBook
+{
+public:
+
+    /**
+    * @brief The Section struct
+    * A decision tree of the book
+    */
+    struct Section {
+        quint8 colors;
+        quint8 pegs;
+        quint8 sameColors;
+        quint8 algorithm;
+        quint8 engine;
+        quint8 plies;
+        QVector<quint32> nodes; /**< the nodes, each one is a key and the children */
+    };
+
+    static const quint16 VERSION = 1; /**< the version of the book format */
+
+    OpeningBook();
+    ~OpeningBook();
+
+    /**
+     * @brief instance the book of the application, loaded from the default
+     * locations on the first call
+     * @return OpeningBook* the book of the application
+     */
+    static OpeningBook* instance();
+
+    /**
+     * @brief load map a book file
+     * @param file_name the book file
+     * @return true if the book is valid, false otherwise
+     */
+    bool load(const QString& file_name);
+
+    /**
+     * @brief save write a book file
+     * @param file_name the book file
+     * @param sections the decision trees
+     * @return true if the book is written, false otherwise
+     */
+    static bool save(const QString& file_name, const QList<Section>& sections);
+
+    /**
+     * @brief hasSection is there a tree for a configuration
+     * @return true if there is a tree, false otherwise
+     */
+    bool hasSection(const int& colors, const int& pegs, const bool& same_colors,
+                    const Algorithm& algorithm, const Engine& engine) const;
+
+    /**
+     * @brief find find the next guess of a game history
+     * @param guesses the played guesses, pegs colors for each guess
+     * @param responses the response index of each played guess
+     * @param guess the next guess
+     * @return true if the history is in the book, false otherwise
+     */
+    bool find(const int& colors, const int& pegs, const bool& same_colors,
+              const Algorithm& algorithm, const Engine& engine,
+              const QVector<unsigned char>& guesses, const QVector<int>& responses,
+              unsigned char* guess) const;
+
+private:
+    /**
+     * @brief findSection find the offset of a section header
+     * @return int the offset of the section header, -1 if not found
+     */
+    int findSection(const int& colors, const int& pegs, const bool& same_colors,
+                    const Algorithm& algorithm, const Engine& engine) const;
+
+    quint32 readNumber(const qint64& offset, const int& size = 4) const;
+
+private:
+    QFile mFile; /**< the mapped file */
+    QByteArray mBuffer; /**< the content of the book, if the file could not be mapped */
+    const uchar* mData; /**< the book content */
+    qint64 mSize; /**< the size of the book content */
+};
+
+#endif // OPENINGBOOK_H
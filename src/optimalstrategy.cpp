@@ -0,0 +1,316 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "optimalstrategy.h"
+#include <QSet>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <climits>
+
+OptimalStrategy::OptimalStrategy(const int& colors, const int& pegs, const bool& same_colors,
+                                 const Objective& objective):
+    mTables(CodeTables::acquire(colors, pegs, same_colors)),
+    mObjective(objective),
+    mMaxResponse((pegs + 1)*(pegs + 2)/2),
+    mCost(0)
+{
+    // at most b^(d-1) secrets are found by the d-th guess
+    const qint64 branches = mMaxResponse - 2;
+    mLowerBounds.resize(mTables->size() + 1);
+    for(int size = 0; size < mLowerBounds.size(); ++size) {
+        int remaining = size;
+        int depth = 0;
+        int total = 0;
+        for(qint64 level = 1; remaining > 0; level *= branches) {
+            ++depth;
+            int found = (int) qMin((qint64) remaining, level);
+            total += depth*found;
+            remaining -= found;
+        }
+        mLowerBounds[size] = (mObjective == Objective::EXPECTED_GUESSES) ? total : depth;
+    }
+}
+
+int OptimalStrategy::solve()
+{
+    QVector<int> possibles(mTables->size());
+    for(int i = 0; i < possibles.size(); ++i)
+        possibles[i] = i;
+    mCost = solve(possibles, true);
+    return mCost;
+}
+
+int OptimalStrategy::solve(const QVector<int>& possibles, const bool& parallel)
+{
+    int guess;
+    return search(possibles, INT_MAX, &guess, parallel);
+}
+
+OpeningBook::Section OptimalStrategy::section()
+{
+    OpeningBook::Section section;
+    section.colors = mTables->colors();
+    section.pegs = mTables->pegs();
+    section.sameColors = mTables->sameColors() ? 1 : 0;
+    section.algorithm = static_cast<quint8>(Algorithm::OPTIMAL);
+    section.engine = static_cast<quint8>(Engine::ONE_STEP);
+    section.plies = 0;
+    if (mCost == 0)
+        return section;
+
+    QVector<int> all(mTables->size());
+    for(int i = 0; i < all.size(); ++i)
+        all[i] = i;
+    int depth;
+    section.nodes = tree(all, &depth);
+    section.plies = depth;
+    return section;
+}
+
+QVector<quint32> OptimalStrategy::tree(const QVector<int>& possibles, int* depth)
+{
+    QVector<quint32> tree_nodes;
+    *depth = 0;
+
+    // the nodes in breadth first order, together with their depth
+    QList<QVector<int> > nodes;
+    QList<int> depths;
+    nodes.append(possibles);
+    depths.append(1);
+    for(int node = 0; node < nodes.size(); ++node) {
+        const QVector<int> node_possibles = nodes.at(node);
+        int guess = node_possibles.first();
+        if (node_possibles.size() > 2) {
+            QMutexLocker locker(&mMemoMutex);
+            guess = mMemo.value(memoKey(node_possibles)).guess;
+        }
+
+        quint32 key = 0;
+        const unsigned char* code = mTables->code(guess);
+        for(int i = 0; i < mTables->pegs(); ++i)
+            key = key*mTables->colors() + code[i];
+        tree_nodes.append(key);
+        *depth = qMax(*depth, depths.at(node));
+
+        QVector<QVector<int> > parts(mMaxResponse);
+        foreach(int possible, node_possibles)
+            parts[mTables->response(guess, possible)].append(possible);
+        for(int response = 0; response < mMaxResponse; ++response) {
+            if (response == mMaxResponse - 1 || parts.at(response).isEmpty()) {
+                tree_nodes.append(0);
+            } else {
+                tree_nodes.append(nodes.size());
+                nodes.append(parts.at(response));
+                depths.append(depths.at(node) + 1);
+            }
+        }
+    }
+    return tree_nodes;
+}
+
+QVector<int> OptimalStrategy::firstGuesses() const
+{
+    // before any guess, the slots and the colors are all interchangeable, so
+    // the codes with the same color multiplicities are equivalent
+    QVector<int> guesses;
+    QSet<QByteArray> seen;
+    for(int guess = 0; guess < mTables->size(); ++guess) {
+        QByteArray multiplicities(mTables->colors(), 0);
+        const unsigned char* code = mTables->code(guess);
+        for(int i = 0; i < mTables->pegs(); ++i)
+            ++multiplicities[code[i]];
+        std::sort(multiplicities.begin(), multiplicities.end());
+        if (seen.contains(multiplicities))
+            continue;
+        seen.insert(multiplicities);
+        guesses.append(guess);
+    }
+    return guesses;
+}
+
+int OptimalStrategy::search(const QVector<int>& possibles, const int& bound, int* guess, const bool& parallel)
+{
+    const int size = possibles.size();
+    if (size <= 2) {
+        // guess one of them, the other one, if any, is found by the next guess
+        *guess = possibles.first();
+        return (mObjective == Objective::EXPECTED_GUESSES) ? 2*size - 1 : size;
+    }
+    if (bound <= lowerBound(size))
+        return lowerBound(size);
+
+    const QByteArray key = memoKey(possibles);
+    {
+        QMutexLocker locker(&mMemoMutex);
+        QHash<QByteArray, Entry>::const_iterator it = mMemo.constFind(key);
+        if (it != mMemo.constEnd() && (it.value().exact || it.value().cost >= bound)) {
+            if (it.value().exact)
+                *guess = it.value().guess;
+            return it.value().cost;
+        }
+    }
+
+    int best = bound;
+    int best_guess = -1;
+    int lower = INT_MAX;
+    foreach(const Candidate& candidate, candidates(possibles)) {
+        if (candidate.bound >= best) {
+            // the candidates are sorted by their bounds, none of the rest can be better
+            lower = qMin(lower, candidate.bound);
+            break;
+        }
+
+        const int parts_size = candidate.parts.size();
+        QVector<int> costs(parts_size);
+        for(int i = 0; i < parts_size; ++i)
+            costs[i] = lowerBound(candidate.parts.at(i).size());
+
+        // the bound of a part, such that the guess still beats the best one
+        auto part_bound = [&](const QVector<int>& part_costs, const int& part) {
+            if (mObjective == Objective::WORST_CASE)
+                return best - 1;
+            int others = size;
+            for(int i = 0; i < parts_size; ++i)
+                if (i != part)
+                    others += part_costs.at(i);
+            return best - others;
+        };
+
+        if (parallel) {
+            // data() detaches the costs from the bounds here, once, so that the
+            // threads write through a block of their own and never detach it
+            const QVector<int> bounds_costs = costs;
+            int* part_costs = costs.data();
+            QVector<int> parts(parts_size);
+            for(int i = 0; i < parts_size; ++i)
+                parts[i] = i;
+            QtConcurrent::blockingMap(parts, [&](int& part) {
+                int part_guess;
+                part_costs[part] = search(candidate.parts.at(part), part_bound(bounds_costs, part), &part_guess);
+            });
+        } else {
+            for(int i = 0; i < parts_size && combine(size, costs) < best; ++i) {
+                int part_guess;
+                costs[i] = search(candidate.parts.at(i), part_bound(costs, i), &part_guess);
+            }
+        }
+
+        int cost = combine(size, costs);
+        if (cost < best) {
+            best = cost;
+            best_guess = candidate.guess;
+        } else {
+            lower = qMin(lower, cost);
+        }
+    }
+
+    Entry entry;
+    entry.exact = (best_guess >= 0);
+    entry.cost = entry.exact ? best : lower;
+    entry.guess = best_guess;
+
+    QMutexLocker locker(&mMemoMutex);
+    Entry& memo = mMemo[key];
+    if (entry.exact || !memo.exact)
+        memo = entry;
+    if (entry.exact)
+        *guess = best_guess;
+    return entry.cost;
+}
+
+QVector<OptimalStrategy::Candidate> OptimalStrategy::candidates(const QVector<int>& possibles) const
+{
+    const int size = possibles.size();
+    QVector<Candidate> candidates;
+    QSet<QByteArray> seen;
+    QByteArray responses(size, 0);
+    QVector<int> part_sizes(mMaxResponse);
+
+    for(int guess = 0; guess < mTables->size(); ++guess) {
+        part_sizes.fill(0);
+        for(int i = 0; i < size; ++i) {
+            int response = mTables->response(guess, possibles.at(i));
+            responses[i] = response;
+            ++part_sizes[response];
+        }
+
+        // a guess that does not split the possibles is useless
+        bool useless = false;
+        for(int response = 0; response < mMaxResponse - 1; ++response)
+            useless = useless || part_sizes.at(response) == size;
+        // the guesses that split the possibles the same way are equivalent
+        if (useless || seen.contains(responses))
+            continue;
+        seen.insert(responses);
+
+        Candidate candidate;
+        candidate.guess = guess;
+        QVector<int> part_index(mMaxResponse, -1);
+        QVector<int> bounds;
+        for(int response = 0; response < mMaxResponse - 1; ++response) {
+            if (part_sizes.at(response) > 0) {
+                part_index[response] = candidate.parts.size();
+                candidate.parts.append(QVector<int>());
+                candidate.parts.last().reserve(part_sizes.at(response));
+                bounds.append(lowerBound(part_sizes.at(response)));
+            }
+        }
+        for(int i = 0; i < size; ++i) {
+            int response = (unsigned char) responses.at(i);
+            if (response != mMaxResponse - 1)
+                candidate.parts[part_index.at(response)].append(possibles.at(i));
+        }
+        // the largest parts first, they are the most likely to exceed the bound
+        std::sort(candidate.parts.begin(), candidate.parts.end(), [](const QVector<int>& a, const QVector<int>& b) {
+            return a.size() > b.size();
+        });
+        candidate.bound = combine(size, bounds);
+        candidates.append(candidate);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.bound < b.bound;
+    });
+    return candidates;
+}
+
+int OptimalStrategy::combine(const int& size, const QVector<int>& part_costs) const
+{
+    int cost = 0;
+    if (mObjective == Objective::EXPECTED_GUESSES) {
+        cost = size;
+        foreach(int part_cost, part_costs)
+            cost += part_cost;
+    } else {
+        foreach(int part_cost, part_costs)
+            cost = qMax(cost, part_cost);
+        ++cost;
+    }
+    return cost;
+}
+
+int OptimalStrategy::lowerBound(const int& size) const
+{
+    return mLowerBounds.at(size);
+}
+
+QByteArray OptimalStrategy::memoKey(const QVector<int>& possibles)
+{
+    return QByteArray(reinterpret_cast<const char*>(possibles.constData()), possibles.size()*sizeof(int));
+}
@@ -0,0 +1,160 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef OPTIMALSTRATEGY_H
+#define OPTIMALSTRATEGY_H
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include "codetables.h"
+#include "openingbook.h"
+
+/**    @brief The class OptimalStrategy finds an optimal decision tree of a small
+ *    configuration, by a branch and bound search over all the codes as guesses.
+ *
+ *    The cost of a tree is either the total number of guesses over all the
+ *    secrets, which is the expected number of guesses times the number of codes,
+ *    or its depth, the worst case number of guesses. A guess from a node is
+ *    followed by at most b = (p+1)(p+2)/2 - 2 parts, so at most \f$ b^{d-1} \f$
+ *    secrets are found by the d-th guess. This gives the lower bound of a part
+ *    from its size alone, and a guess is skipped once the bounds of its parts
+ *    show it can not beat the best guess so far.
+ *
+ *    The exact costs of the subproblems are memoized by their possibles, and
+ *    the parts of each first guess are searched in parallel.
+ */
+class OptimalStrategy
+{
+public:
+
+    /**
+     * @brief The Objective enum
+     */
+    enum class Objective {
+        EXPECTED_GUESSES,   // the least total number of guesses
+        WORST_CASE          // the least number of guesses for the hardest secret
+    };
+
+    OptimalStrategy(const int& colors, const int& pegs, const bool& same_colors,
+                    const Objective& objective = Objective::EXPECTED_GUESSES);
+
+    /**
+     * @brief solve search the optimal tree from the first guess
+     * @return int the cost of the optimal tree
+     */
+    int solve();
+
+    /**
+     * @brief solve search the optimal tree of some possibles
+     * @param possibles the sorted possibles
+     * @param parallel search the parts of each guess in parallel
+     * @return int the cost of the optimal tree
+     */
+    int solve(const QVector<int>& possibles, const bool& parallel);
+
+    /**
+     * @brief section the optimal tree in the format of the opening book, under
+     * the Optimal algorithm, to be called after solve
+     * @return OpeningBook::Section the tree
+     */
+    OpeningBook::Section section();
+
+    /**
+     * @brief tree the optimal tree of some possibles in the node format of the
+     * opening book, where the root is the first node, to be called after solve
+     * @param possibles the sorted possibles
+     * @param depth the depth of the tree
+     * @return QVector<quint32> the nodes
+     */
+    QVector<quint32> tree(const QVector<int>& possibles, int* depth);
+
+    /**
+     * @brief firstGuesses one first guess of each class of codes with the
+     * same color multiplicities, the only first guesses that differ
+     * @return QVector<int> the code indices of the guesses
+     */
+    QVector<int> firstGuesses() const;
+
+    /**
+     * @brief combine the cost of a guess from the costs of its parts
+     * @param size the number of possibles
+     * @param part_costs the cost of each part
+     * @return int the cost of the guess
+     */
+    int combine(const int& size, const QVector<int>& part_costs) const;
+
+private:
+    /**
+    * @brief The Entry struct
+    * A memoized subproblem
+    */
+    struct Entry {
+        int cost;
+        bool exact; /**< is the cost exact, or only a lower bound? */
+        int guess; /**< the best guess, if the cost is exact */
+    };
+
+    /**
+    * @brief The Candidate struct
+    * A guess and the parts of its responses
+    */
+    struct Candidate {
+        int guess;
+        int bound; /**< the lower bound of the cost */
+        QVector<QVector<int> > parts; /**< the possibles of each response, but the win */
+    };
+
+    /**
+     * @brief search the cost of the best guess of some possibles
+     * @param possibles the sorted possibles
+     * @param bound the cost to beat
+     * @param guess the best guess, if the cost is less than the bound
+     * @param parallel search the parts of each guess in parallel
+     * @return int the exact cost if it is less than the bound, a lower bound otherwise
+     */
+    int search(const QVector<int>& possibles, const int& bound, int* guess, const bool& parallel = false);
+
+    /**
+     * @brief candidates the guesses that split the possibles differently
+     * @param possibles the possibles
+     * @return QVector<Candidate> the guesses, sorted by their lower bounds
+     */
+    QVector<Candidate> candidates(const QVector<int>& possibles) const;
+
+    /**
+     * @brief lowerBound the least cost of a number of possibles
+     * @param size the number of possibles
+     * @return int the lower bound
+     */
+    int lowerBound(const int& size) const;
+
+    static QByteArray memoKey(const QVector<int>& possibles);
+
+private:
+    QSharedPointer<const CodeTables> mTables; /**< the codes of the configuration */
+    Objective mObjective; /**< the optimized cost */
+    int mMaxResponse; /**< maximum number of responses */
+    QVector<int> mLowerBounds; /**< the lower bound of each part size */
+    QHash<QByteArray, Entry> mMemo; /**< the subproblems by their possibles */
+    QMutex mMemoMutex; /**< guards the memo */
+    int mCost; /**< the cost of the optimal tree, 0 if not solved */
+};
+
+#endif // OPTIMALSTRATEGY_H
@@ -19,6 +19,7 @@
 
 #include "peg.h"
 #include "appinfo.h"
+#include "tracer.h"
 #include <QGraphicsDropShadowEffect>
 #include <QGraphicsSceneMouseEvent>
 #include <QCursor>
@@ -188,6 +189,7 @@ void Peg::tapGestureTriggered(QTapGesture* gesture)
 
 void Peg::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
 {
+    TRACE_SCOPE("Peg::paint", "paint");
     painter->setPen(Qt::NoPen);
     int virtual_color = (sShowColors || !sShowIndicators) ? mColor : 3;
 
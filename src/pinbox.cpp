@@ -67,6 +67,9 @@ void PinBox::setPins(const int& bl, const int& wt)
 
     for(int i = bl; i < bl+wt; ++i)
         mPins.at(i)->setColor(Pin::Color::WHITE);
+
+    for(int i = bl+wt; i < mPins.size(); ++i)
+        mPins.at(i)->setColor(Pin::Color::NONE);
 }
 
 void PinBox::setState(const Box::State& _state)
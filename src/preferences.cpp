@@ -20,10 +20,14 @@
 #include "preferences.h"
 #include "ui_preferences.h"
 #include "tools.h"
+#include "latencystats.h"
 
+#include <QApplication>
 #include <QFile>
 #include <QLibraryInfo>
 #include <QDir>
+#include <QFileDialog>
+#include <QMessageBox>
 
 Preferences::Preferences(Tools* tools, QWidget* parent) :
     QDialog(parent),
@@ -39,8 +43,15 @@ Preferences::Preferences(Tools* tools, QWidget* parent) :
     ui->fontComboBox->setCurrentFont(mTools->mFontName);
     ui->sizeComboBox->setCurrentIndex(mTools->mFontSize - 10);
 
+    ui->solverGroupBox->setTitle(tr("Solver"));
+    ui->calibrateButton->setText(tr("Calibrate"));
+    ui->exportLatenciesButton->setText(tr("Export Latencies"));
+    showCalibration();
+
     connect(ui->acceptRejectButtonBox, SIGNAL(accepted()), this, SLOT(accept()));
     connect(ui->acceptRejectButtonBox, SIGNAL(rejected()), this, SLOT(reject()));
+    connect(ui->calibrateButton, SIGNAL(clicked()), this, SLOT(onCalibrate()));
+    connect(ui->exportLatenciesButton, SIGNAL(clicked()), this, SLOT(onExportLatencies()));
 
 }
 
@@ -61,3 +72,34 @@ void Preferences::accept()
         emit fontChangedSignal();
     }
 }
+
+void Preferences::onCalibrate()
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    mTools->calibrate();
+    QApplication::restoreOverrideCursor();
+    showCalibration();
+}
+
+void Preferences::onExportLatencies()
+{
+    QString file_name = QFileDialog::getSaveFileName(this, tr("Export Latencies"),
+                                                     QDir::homePath() + "/qtmind-latencies.csv",
+                                                     tr("CSV Files (*.csv)"));
+    if (file_name.isEmpty())
+        return;
+    if (!LatencyStats::instance()->exportReport(file_name))
+        QMessageBox::warning(this, tr("Export Latencies"), tr("Could not write %1").arg(file_name));
+}
+
+void Preferences::showCalibration()
+{
+    const Solver::Calibration& calibration = mTools->mCalibration;
+    ui->calibrationLabel->setText(QString("%1: %2\n%3: %4\n%5: %6\n%7: %8").
+                                  arg(tr("Threads")).arg(mTools->mLocale.toString(calibration.threads)).
+                                  arg(tr("Comparisons Per Second")).
+                                  arg(mTools->mLocale.toString(calibration.comparisonsPerSecond, 'f', 0)).
+                                  arg(tr("Weighted Possibles")).arg(mTools->mLocale.toString(calibration.exactLimit)).
+                                  arg(tr("Look Ahead Comparisons")).
+                                  arg(mTools->mLocale.toString(calibration.lookAheadBudget)));
+}
@@ -49,6 +49,20 @@ signals:
 
 protected slots:
     void accept();
+    /**
+     * @brief onCalibrate measure the machine again and set the limits of the solver
+     */
+    void onCalibrate();
+    /**
+     * @brief onExportLatencies save the latency percentiles of the played games
+     */
+    void onExportLatencies();
+
+private:
+    /**
+     * @brief showCalibration show the limits of the solver
+     */
+    void showCalibration();
 
 private:
     Ui::Preferences* ui; /**< TODO */
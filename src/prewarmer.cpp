@@ -0,0 +1,95 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "prewarmer.h"
+#include "appinfo.h"
+
+Prewarmer::Prewarmer(QObject* parent):
+    QThread(parent),
+    mRunning(false)
+{
+}
+
+Prewarmer::~Prewarmer()
+{
+    mMutex.lock();
+    mPending.clear();
+    mMutex.unlock();
+    wait();
+}
+
+void Prewarmer::prewarm(const int& colors, const int& pegs, const bool& same_colors, const bool& neighbors)
+{
+    QList<Configuration> configurations;
+    Configuration configuration = {colors, pegs, same_colors};
+    configurations.append(configuration);
+    if (neighbors) {
+        Configuration near[] = {{colors, pegs, !same_colors},
+                                {colors + 1, pegs, same_colors},
+                                {colors - 1, pegs, same_colors},
+                                {colors, pegs + 1, same_colors},
+                                {colors, pegs - 1, same_colors}};
+        for(int i = 0; i < 5; ++i) {
+            if (near[i].colors >= MIN_COLOR_NUMBER && near[i].colors <= MAX_COLOR_NUMBER &&
+                    near[i].pegs >= MIN_SLOT_NUMBER && near[i].pegs <= MAX_SLOT_NUMBER &&
+                    (near[i].sameColors || near[i].pegs <= near[i].colors))
+                configurations.append(near[i]);
+        }
+    }
+
+    QMutexLocker locker(&mMutex);
+    mRequested = configurations;
+    mPending = configurations;
+    if (!mRunning) {
+        // the thread may be still returning from its last run
+        wait();
+        mRunning = true;
+        start(QThread::LowPriority);
+    }
+}
+
+void Prewarmer::run()
+{
+    QList<QSharedPointer<const CodeTables> > tables;
+    forever {
+        mMutex.lock();
+        if (mPending.isEmpty()) {
+            // the new tables are held before the old ones are released, and
+            // the ones of an older request are dropped
+            QList<QSharedPointer<const CodeTables> > requested;
+            foreach(const QSharedPointer<const CodeTables>& table, tables) {
+                foreach(const Configuration& configuration, mRequested) {
+                    if (table->colors() == configuration.colors && table->pegs() == configuration.pegs &&
+                            table->sameColors() == configuration.sameColors) {
+                        requested.append(table);
+                        break;
+                    }
+                }
+            }
+            mTables = requested;
+            mRunning = false;
+            mMutex.unlock();
+            return;
+        }
+        Configuration configuration = mPending.takeFirst();
+        mMutex.unlock();
+
+        tables.append(CodeTables::acquire(configuration.colors, configuration.pegs, configuration.sameColors));
+    }
+}
@@ -0,0 +1,74 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef PREWARMER_H
+#define PREWARMER_H
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include "codetables.h"
+
+/**    @brief The class Prewarmer builds the code tables of a configuration and its
+ *    neighbors on a low priority thread, and holds them, so that starting a game
+ *    or switching the colors, pegs or same colors does not wait for the tables.
+ */
+class Prewarmer : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit Prewarmer(QObject* parent = 0);
+    ~Prewarmer();
+
+    /**
+     * @brief prewarm build the tables of a configuration, and the ones of its
+     * neighbors, replacing the previously held tables
+     * @param colors the number of colors
+     * @param pegs the number of pegs
+     * @param same_colors same color allowed flag
+     * @param neighbors also build the configurations that differ by one color,
+     * one peg or the same color flag
+     */
+    void prewarm(const int& colors, const int& pegs, const bool& same_colors, const bool& neighbors = true);
+
+protected:
+    /**
+     * @brief run method of the thread
+     */
+    void run();
+
+private:
+    /**
+    * @brief The Configuration struct
+    */
+    struct Configuration {
+        int colors;
+        int pegs;
+        bool sameColors;
+    };
+
+    QMutex mMutex; /**< guards the pending configurations and the running flag */
+    QList<Configuration> mRequested; /**< the configurations of the last request */
+    QList<Configuration> mPending; /**< the configurations to be built */
+    bool mRunning; /**< is the thread building? */
+    QList<QSharedPointer<const CodeTables> > mTables; /**< the held tables */
+};
+
+#endif // PREWARMER_H
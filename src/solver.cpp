@@ -19,12 +19,50 @@
 
 #include "solver.h"
 #include "guess.h"
+#include "openingbook.h"
+#include "transpositiontable.h"
+#include "tracer.h"
 #include "ctime"
 #include <QtCore/qmath.h>
 #include <stdlib.h>
+#include <climits>
+#include <algorithm>
 #include <QDebug>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
+#include <QThreadPool>
+#include <QMutex>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+#include <QLoggingCategory>
+#endif
 
-inline static void array_copy(unsigned char* A, unsigned char* B, int N) {
+static const int LOOKAHEAD_WIDTH = 8; /**< The number of candidates weighted two plies ahead */
+static const int CALIBRATION_TIME = 30; /**< The time of a speed measure of the calibration, in milliseconds */
+static const int AUTO_LATENCY = 500; /**< The target latency of a turn in the auto engine, in milliseconds */
+static const int SELECTIVITY_SAMPLE = 1024; /**< The number of codes that estimate how selective a row is */
+static const int FILTER_CHUNK = 4096; /**< The number of codes filtered by a task of setHistory */
+
+Solver::Calibration Solver::sCalibration = {0, QThread::idealThreadCount(), 10000, 100000000};
+static QMutex calibrationMutex; // the preferences calibrate while the solvers of a game read the limits
+
+// the choice of the auto engine on each turn, to be audited; it is silenced by
+// the logging rule qtmind.auto=false
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+Q_LOGGING_CATEGORY(autoEngineLog, "qtmind.auto")
+#define AUTO_ENGINE_LOG qCDebug(autoEngineLog)
+#else
+#define AUTO_ENGINE_LOG qDebug()
+#endif
+
+// the metrics statements are compiled only on demand, they cost nothing otherwise
+#ifdef QTMIND_METRICS
+#define METRICS(...) __VA_ARGS__
+#else
+#define METRICS(...)
+#endif
+
+inline static void array_copy(const unsigned char* A, unsigned char* B, int N) {
     for (int i = 0; i < N; i++)
         B[i] = A[i];
 }
@@ -43,10 +81,17 @@ int Solver::ipow(int base, int exp) {
 Solver::Solver(Guess* guess, QObject* parent):
     QThread(parent),
     mInterupt(true),
-    mGuess(guess)
+    mPrunedCandidates(0),
+    mMetrics(),
+    mGuess(guess),
+    mOpeningBook(OpeningBook::instance()),
+    mTranspositionTable(TranspositionTable::instance()),
+    mInBook(false),
+    mSnapshot(0),
+    mLocating(false)
 {
-    mCodes.index = NULL;
     mSmallPossibles.index = NULL;
+    mCalibration = calibration();
 }
 
 Solver::~Solver()
@@ -56,74 +101,53 @@ Solver::~Solver()
 
 void Solver::createTables()
 {
-    if (mSameColors) {
-        mCodes.size = ipow(mColors, mPegs);
-    } else {
-        mCodes.size = 1;
-        for(int i = 0; i < mPegs; ++i)
-            mCodes.size *= (mColors - i);
-    }
-
+    TRACE_SCOPE("Solver::createTables", "solver");
+    // the old tables are released after the new ones are acquired, so that
+    // a new game of the same configuration shares them
+    mTables = CodeTables::acquire(mColors, mPegs, mSameColors);
     mMaxResponse = (mPegs + 1)*(mPegs + 2)/2;
 
-    mCodes.index = new unsigned char* [mCodes.size];
-
-    for(int i = 0; i < mCodes.size; ++i) {
-        mCodes.index[i] = new unsigned char[mPegs];
-    }
-
-    if (mSameColors) {
-        for (int i = 0; i < mPegs; i++)
-            mCodes.index[0][i] = 0;
-        for (int i = 1; i < mCodes.size; i++) {
-            array_copy(mCodes.index[i-1], mCodes.index[i], mPegs);
-            nextCodeSameColor(mCodes.index[i]);
-        }
-    } else {
-        for (int i = 0; i < mPegs; i++)
-            mCodes.index[0][i] = i;
-        for (int i = 1; i < mCodes.size; i++) {
-            array_copy(mCodes.index[i-1], mCodes.index[i], mPegs);
-            nextCodeDifferentColor(mCodes.index[i]);
-        }
-    }
-
-    for(int i = 0; i < mCodes.size; ++i)
+    for(int i = 0; i < mTables->size(); ++i)
         mPossibles.append(i);
+
+    mPlayedColors = 0;
+    mLiveColors = (1 << mColors) - 1;
+    mSnapshots.append(takeSnapshot());
+    mSnapshot = 0;
 }
 
 void Solver::deleteTables()
 {
-    if (mCodes.index != NULL) {
-        for(int i = 0; i < mCodes.size; ++i)
-            delete[] mCodes.index[i];
-
-        delete[] mCodes.index;
-        mCodes.index = NULL;
-    }
-
     if(mSmallPossibles.index) {
         delete[] mSmallPossibles.index;
         mSmallPossibles.index = NULL;
     }
 
     mPossibles.clear();
+    mHistory.clear();
+    mSymmetries.clear();
+    mSnapshots.clear();
+    mSnapshot = 0;
+    mInBook = false;
 }
 
 int Solver::reset(const int& colors, const int& pegs, const bool& same_colors)
 {
+    TRACE_SCOPE("Solver::reset", "solver");
     mColors = colors;
     mPegs = pegs;
     mSameColors = same_colors;
+    mCalibration = calibration();
     deleteTables();
     createTables();
-    return mCodes.size;
+    return mTables->size();
 }
 
-void Solver::startGuessing(const Algorithm& alg)
+void Solver::startGuessing(const Algorithm& alg, const Engine& engine)
 {
     mInterupt = false;
     mAlgorithm = alg; // to prevent change in algorithm by user in the middle of computation
+    mEngine = engine;
     start(QThread::NormalPriority);
 }
 
@@ -150,32 +174,297 @@ void Solver::permute(unsigned char* m_code) const
 
 bool Solver::setResponse(const int& blacks, const int& whites, const unsigned char *guess)
 {
+    TRACE_SCOPE("Solver::setResponse", "solver");
+    METRICS(QElapsedTimer filter_timer; filter_timer.start();)
     QList<int> temppossibles;
     int bl, wt;
+    int live_colors = 0;
     foreach(int possible, mPossibles) {
-        COMPARE(guess, mCodes.index[possible], mColors, mPegs, bl, wt);
-        if (blacks == bl && whites == wt)
+        COMPARE(guess, mTables->code(possible), mColors, mPegs, bl, wt);
+        if (blacks == bl && whites == wt) {
             temppossibles.append(possible);
+            for(int i = 0; i < mPegs; ++i)
+                live_colors |= 1 << mTables->code(possible)[i];
+        }
     }
+    METRICS(mMetrics.filterTime = filter_timer.nsecsElapsed()/1000;)
 
     if (temppossibles.isEmpty())
         return false;
     mPossibles = temppossibles;
+    mLiveColors = live_colors;
+    for(int i = 0; i < mPegs; ++i)
+        mPlayedColors |= 1 << guess[i];
+
+    Row row;
+    array_copy(guess, row.guess, mPegs);
+    row.blacks = blacks;
+    row.whites = whites;
+    mHistory.append(row);
+
     mGuess->update(blacks, whites, mPossibles.size());
     setSmallPossibles();
+
+    // the undone responses can not be redone after a new one
+    while (mSnapshots.size() > mSnapshot + 1)
+        mSnapshots.removeLast();
+    mSnapshots.append(takeSnapshot());
+    ++mSnapshot;
     return true;
 }
 
+bool Solver::setHistory(const QVector<unsigned char>& guesses, const QVector<int>& responses)
+{
+    /**
+    * @brief The Constraint struct
+    * A row of the history, with the total of its guess with each multiset group
+    */
+    struct Constraint {
+        const unsigned char* guess;
+        int response;
+        QVector<unsigned char> totals;
+        int hits; /**< the number of sampled codes that satisfy the row */
+    };
+
+    const int rows_size = responses.size();
+    if (guesses.size() != rows_size*mPegs)
+        return false;
+    foreach(unsigned char color, guesses)
+        if (color >= mColors)
+            return false;
+    foreach(int response, responses)
+        if (response < 0 || response >= mMaxResponse)
+            return false;
+    TRACE_SCOPE("Solver::setHistory", "solver");
+    METRICS(QElapsedTimer filter_timer; filter_timer.start();)
+
+    QVector<Constraint> constraints(rows_size);
+    for(int row = 0; row < rows_size; ++row) {
+        constraints[row].guess = guesses.constData() + row*mPegs;
+        constraints[row].response = responses.at(row);
+        constraints[row].totals = mTables->totals(constraints[row].guess);
+        constraints[row].hits = 0;
+    }
+
+    auto satisfies = [this](const Constraint& constraint, const int& code_index) {
+        const unsigned char* code = mTables->code(code_index);
+        int blacks = 0;
+        for(int i = 0; i < mPegs; ++i)
+            blacks += (code[i] == constraint.guess[i]);
+        int total = constraint.totals.constData()[mTables->group(code_index)];
+        return total*(total + 1)/2 + blacks == constraint.response;
+    };
+
+    const QVector<Constraint> play_order = constraints;
+    // the most selective rows first, so that most codes fail on the first checked row
+    const int step = qMax(1, mTables->size()/SELECTIVITY_SAMPLE);
+    for(int code_index = 0; code_index < mTables->size(); code_index += step)
+        for(int row = 0; row < rows_size; ++row)
+            constraints[row].hits += satisfies(constraints.at(row), code_index);
+    std::stable_sort(constraints.begin(), constraints.end(), [](const Constraint& a, const Constraint& b) {
+        return a.hits < b.hits;
+    });
+
+    /*    The codes that satisfy the rows, filtered in parallel chunks. A code
+     *    is dropped at the first row that it fails, and the codes are kept in
+     *    their order. The codes are all the codes if none are given.
+     */
+    auto filter = [&](const QVector<int>& codes, const QVector<Constraint>& rows) {
+        const int size = codes.isEmpty() ? mTables->size() : codes.size();
+        QVector<int> chunks((size + FILTER_CHUNK - 1)/FILTER_CHUNK);
+        for(int i = 0; i < chunks.size(); ++i)
+            chunks[i] = i;
+        QVector<QVector<int> > chunk_codes(chunks.size());
+        QtConcurrent::blockingMap(chunks, [&](int& chunk) {
+            TRACE_SCOPE("setHistory chunk", "worker");
+            QVector<int>& kept = chunk_codes[chunk];
+            const int end = qMin(size, (chunk + 1)*FILTER_CHUNK);
+            for(int i = chunk*FILTER_CHUNK; i < end; ++i) {
+                const int code_index = codes.isEmpty() ? i : codes.at(i);
+                int row = 0;
+                while (row < rows.size() && satisfies(rows.at(row), code_index))
+                    ++row;
+                if (row == rows.size())
+                    kept.append(code_index);
+            }
+        });
+        QVector<int> kept;
+        foreach(const QVector<int>& chunk, chunk_codes)
+            kept += chunk;
+        return kept;
+    };
+
+    const QVector<int> possibles = filter(QVector<int>(), constraints);
+
+    /*    As the responses are set one by one, the candidates are the possibles
+     *    of the first rows whose possibles fall under the exact limit. They are
+     *    only needed if the final possibles are under it, and the rows are then
+     *    filtered again in the play order, until the possibles fall under it.
+     */
+    QVector<int> small_possibles;
+    if (!possibles.isEmpty() && possibles.size() <= mCalibration.exactLimit &&
+            mTables->size() > mCalibration.exactLimit) {
+        // the first row filters all the codes, the others the survivors, which are never empty
+        for(int row = 0; row < rows_size && (row == 0 || small_possibles.size() > mCalibration.exactLimit); ++row)
+            small_possibles = filter(small_possibles, play_order.mid(row, 1));
+    }
+    METRICS(mMetrics.filterTime = filter_timer.nsecsElapsed()/1000;)
+    if (possibles.isEmpty())
+        return false;
+
+    mPossibles = possibles.toList();
+    mHistory.clear();
+    mPlayedColors = 0;
+    for(int row = 0; row < rows_size; ++row) {
+        Row history_row;
+        array_copy(guesses.constData() + row*mPegs, history_row.guess, mPegs);
+        int total = 0;
+        while ((total + 1)*(total + 2)/2 <= responses.at(row))
+            ++total;
+        history_row.blacks = responses.at(row) - total*(total + 1)/2;
+        history_row.whites = total - history_row.blacks;
+        mHistory.append(history_row);
+        for(int i = 0; i < mPegs; ++i)
+            mPlayedColors |= 1 << history_row.guess[i];
+    }
+    mLiveColors = 0;
+    foreach(int possible, mPossibles)
+        for(int i = 0; i < mPegs; ++i)
+            mLiveColors |= 1 << mTables->code(possible)[i];
+    // the book is looked up by the history of the game as it is played
+    mInBook = false;
+
+    if (mSmallPossibles.index) {
+        delete[] mSmallPossibles.index;
+        mSmallPossibles.index = NULL;
+    }
+    if (!small_possibles.isEmpty()) {
+        mSmallPossibles.size = small_possibles.size();
+        mSmallPossibles.index = new int[mSmallPossibles.size];
+        std::copy(small_possibles.constBegin(), small_possibles.constEnd(), mSmallPossibles.index);
+    }
+    if (!mHistory.isEmpty()) {
+        mGuess->update(mHistory.last().blacks, mHistory.last().whites, mPossibles.size());
+        setSmallPossibles();
+    }
+    // the rows of the history can not be undone one by one
+    mSnapshots.clear();
+    mSnapshots.append(takeSnapshot());
+    mSnapshot = 0;
+    return true;
+}
+
+bool Solver::undoResponse()
+{
+    if (!canUndo())
+        return false;
+    const Row row = mHistory.takeLast();
+    restoreSnapshot(mSnapshots.at(--mSnapshot));
+    mGuess->update(row.blacks, row.whites, mPossibles.size());
+    return true;
+}
+
+bool Solver::redoResponse(int& blacks, int& whites)
+{
+    if (!canRedo())
+        return false;
+    const Snapshot& snapshot = mSnapshots.at(++mSnapshot);
+    mHistory.append(snapshot.row);
+    restoreSnapshot(snapshot);
+    blacks = snapshot.row.blacks;
+    whites = snapshot.row.whites;
+    mGuess->update(blacks, whites, mPossibles.size());
+    return true;
+}
+
+Solver::Snapshot Solver::takeSnapshot() const
+{
+    Snapshot snapshot;
+    if (!mHistory.isEmpty())
+        snapshot.row = mHistory.last();
+    snapshot.possibles = mPossibles;
+    snapshot.playedColors = mPlayedColors;
+    snapshot.liveColors = mLiveColors;
+    snapshot.inBook = mInBook;
+    snapshot.smallPossibles = (mSmallPossibles.index != NULL);
+    return snapshot;
+}
+
+void Solver::restoreSnapshot(const Snapshot& snapshot)
+{
+    mPossibles = snapshot.possibles;
+    mPlayedColors = snapshot.playedColors;
+    mLiveColors = snapshot.liveColors;
+    mInBook = snapshot.inBook;
+    // the candidates are set once, by the first possibles under the exact limit
+    if (!snapshot.smallPossibles && mSmallPossibles.index) {
+        delete[] mSmallPossibles.index;
+        mSmallPossibles.index = NULL;
+    } else if (snapshot.smallPossibles) {
+        setSmallPossibles();
+    }
+}
+
+void Solver::startLocating(const int& blacks, const int& whites, const unsigned char* guess)
+{
+    mInterupt = false;
+    mLocating = true;
+    array_copy(guess, mLocatingRow.guess, mPegs);
+    mLocatingRow.blacks = blacks;
+    mLocatingRow.whites = whites;
+    start(QThread::LowPriority);
+}
+
+void Solver::locate()
+{
+    mSuspectRows.clear();
+    QList<Row> rows = mHistory;
+    rows.append(mLocatingRow);
+    const int rows_size = rows.size();
+
+    /*    A code that breaks only a few rows is the secret, if the responses
+     *    of those rows are wrong. The rows broken by the codes that break
+     *    the least number of rows are the suspects.
+     */
+    int least = rows_size + 1;
+    int suspects = 0;
+    int bl, wt;
+    for(int code_index = 0; code_index < mTables->size(); ++code_index) {
+        if (mInterupt)
+            return;
+        const unsigned char* code = mTables->code(code_index);
+        int broken = 0;
+        int broken_size = 0;
+        for(int i = 0; i < rows_size && broken_size <= least; ++i) {
+            COMPARE(rows.at(i).guess, code, mColors, mPegs, bl, wt);
+            if (bl != rows.at(i).blacks || wt != rows.at(i).whites) {
+                broken |= 1 << i;
+                ++broken_size;
+            }
+        }
+        if (broken_size < least) {
+            least = broken_size;
+            suspects = broken;
+        } else if (broken_size == least) {
+            suspects |= broken;
+        }
+    }
+
+    for(int i = 0; i < rows_size; ++i)
+        if (suspects & (1 << i))
+            mSuspectRows.append(i);
+}
+
 void Solver::setSmallPossibles()
 {
     if (!mSmallPossibles.index)
     {
-        if (mCodes.size <= 10000) {
-            mSmallPossibles.size = mCodes.size;
+        if (mTables->size() <= mCalibration.exactLimit) {
+            mSmallPossibles.size = mTables->size();
             mSmallPossibles.index = new int[mSmallPossibles.size];
             for(int i = 0; i < mSmallPossibles.size; ++i)
                 mSmallPossibles.index[i] = i;
-        } else if (mPossibles.size() <= 10000) {
+        } else if (mPossibles.size() <= mCalibration.exactLimit) {
             mSmallPossibles.size = mPossibles.size();
             mSmallPossibles.index = new int[mSmallPossibles.size];
             for(int i = 0; i < mSmallPossibles.size; ++i)
@@ -184,55 +473,252 @@ void Solver::setSmallPossibles()
     }
 }
 
+/**
+ * @brief the set of some codes as a bitset, one bit for each code
+ */
+inline static QByteArray codes_to_bits(const int* codes, const int& size, const int& all_codes)
+{
+    QByteArray bits((all_codes + 7)/8, 0);
+    for(int i = 0; i < size; ++i)
+        bits[codes[i] >> 3] = bits.at(codes[i] >> 3) | (1 << (codes[i] & 7));
+    return bits;
+}
+
+/**
+ * @brief the codes of a bitset, in increasing order
+ */
+inline static QVector<int> bits_to_codes(const QByteArray& bits)
+{
+    QVector<int> codes;
+    for(int byte = 0; byte < bits.size(); ++byte) {
+        const uchar value = bits.at(byte);
+        if (!value)
+            continue;
+        for(int bit = 0; bit < 8; ++bit)
+            if (value & (1 << bit))
+                codes.append(8*byte + bit);
+    }
+    return codes;
+}
+
+QByteArray Solver::saveState() const
+{
+    QByteArray state;
+    if (!mTables)
+        return state;
+
+    QDataStream out(&state, QIODevice::WriteOnly);
+    out << (quint8) mColors << (quint8) mPegs << (quint8) mSameColors;
+    out << (quint32) mPlayedColors << (quint32) mLiveColors;
+    out << (quint8) mHistory.size();
+    foreach(const Row& row, mHistory) {
+        for(int i = 0; i < mPegs; ++i)
+            out << (quint8) row.guess[i];
+        out << (quint8) row.blacks << (quint8) row.whites;
+    }
+    out << (quint8) mInBook;
+    for(int i = 0; i < MAX_SLOT_NUMBER; ++i)
+        out << (quint8) mBookSymmetry.pegs[i];
+    for(int i = 0; i < MAX_COLOR_NUMBER; ++i)
+        out << (quint8) mBookSymmetry.colors[i];
+
+    QVector<int> possibles = mPossibles.toVector();
+    out << codes_to_bits(possibles.constData(), possibles.size(), mTables->size());
+    // the candidates are the possibles of the time they got under the exact limit
+    if (mSmallPossibles.index && mSmallPossibles.size != mTables->size())
+        out << codes_to_bits(mSmallPossibles.index, mSmallPossibles.size, mTables->size());
+    else
+        out << QByteArray();
+    return state;
+}
+
+bool Solver::restoreState(const QByteArray& state)
+{
+    QDataStream in(state);
+    quint8 colors, pegs, same_colors, history_size, in_book;
+    quint32 played_colors, live_colors;
+    in >> colors >> pegs >> same_colors >> played_colors >> live_colors >> history_size;
+    if (in.status() != QDataStream::Ok || colors < MIN_COLOR_NUMBER || colors > MAX_COLOR_NUMBER ||
+            pegs < MIN_SLOT_NUMBER || pegs > MAX_SLOT_NUMBER || (!same_colors && pegs > colors) ||
+            history_size > MAX_COLOR_NUMBER)
+        return false;
+
+    QList<Row> history;
+    for(int row_index = 0; row_index < history_size; ++row_index) {
+        Row row;
+        quint8 value;
+        for(int i = 0; i < pegs; ++i) {
+            in >> value;
+            row.guess[i] = value;
+        }
+        in >> value;
+        row.blacks = value;
+        in >> value;
+        row.whites = value;
+        history.append(row);
+    }
+    Symmetry book_symmetry;
+    in >> in_book;
+    for(int i = 0; i < MAX_SLOT_NUMBER; ++i)
+        in >> book_symmetry.pegs[i];
+    for(int i = 0; i < MAX_COLOR_NUMBER; ++i)
+        in >> book_symmetry.colors[i];
+    QByteArray possibles, small_possibles;
+    in >> possibles >> small_possibles;
+
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(colors, pegs, same_colors);
+    const int bits_size = (tables->size() + 7)/8;
+    if (in.status() != QDataStream::Ok || possibles.size() != bits_size ||
+            (!small_possibles.isEmpty() && small_possibles.size() != bits_size))
+        return false;
+    QVector<int> codes = bits_to_codes(possibles);
+    if (codes.isEmpty() || codes.last() >= tables->size())
+        return false;
+
+    mColors = colors;
+    mPegs = pegs;
+    mSameColors = same_colors;
+    mCalibration = calibration();
+    deleteTables();
+    mTables = tables;
+    mMaxResponse = (mPegs + 1)*(mPegs + 2)/2;
+    mPossibles = codes.toList();
+    mHistory = history;
+    mPlayedColors = played_colors;
+    mLiveColors = live_colors;
+    mInBook = in_book;
+    mBookSymmetry = book_symmetry;
+
+    if (!small_possibles.isEmpty()) {
+        codes = bits_to_codes(small_possibles);
+        mSmallPossibles.size = codes.size();
+        mSmallPossibles.index = new int[mSmallPossibles.size];
+        std::copy(codes.constBegin(), codes.constEnd(), mSmallPossibles.index);
+    }
+    setSmallPossibles();
+    // the responses before the saved state can not be undone
+    mSnapshots.append(takeSnapshot());
+    mSnapshot = 0;
+    return true;
+}
+
 void Solver::run()
 {
+    Tracer::setThreadName("Solver");
+    if (mLocating) {
+        mLocating = false;
+        locate();
+        if (!mInterupt)
+            emit locatingDoneSignal();
+        return;
+    }
     makeGuess();
     if (!mInterupt)
         emit guessDoneSignal();
 }
 
+void Solver::firstGuess(const Algorithm& alg, unsigned char* guess) const
+{
+    unsigned char answer[] = {0, 1, 2, 3, 4};
+    if (mSameColors) {
+        switch (mColors) {
+        case 2:
+            answer[2] = 0;
+            answer[3] = 1;
+            answer[2] = 0;
+            break;
+        case 3:
+            answer[3] = 1;
+            answer[4] = 2;
+            break;
+        default:
+            answer[3] = 2;
+            answer[4] = 3;
+            break;
+        }
+        // the classic game (c = 6, p = 4) is best with this first guess on Worst Case
+        if(mColors == 6 && mPegs == 4 && alg == Algorithm::WORST_CASE) {
+            answer[2] = 0;
+            answer[3] = 1;
+        }
+    }
+    array_copy(answer, guess, MAX_SLOT_NUMBER);
+}
+
 void Solver::makeGuess()
 {
+    TRACE_SCOPE("Solver::makeGuess", "solver");
+    METRICS(
+        mMetrics.candidates = 0;
+        mMetrics.prunedCandidates = 0;
+        mMetrics.comparisons = 0;
+        mMetrics.reduceTime = 0;
+        mMetrics.scoreTime = 0;
+        mMetrics.lookAheadTime = 0;
+        mMetrics.engine = mEngine;
+        QElapsedTimer phase_timer;
+    )
+    unsigned char answer[MAX_SLOT_NUMBER];
+    if (openingBookGuess(answer)) {
+        mGuess->setGuess(mPegs, mColors, answer);
+        return;
+    }
+
+    // out of the optimal tree, the game goes on by the closest heuristic
+    if (mAlgorithm == Algorithm::OPTIMAL)
+        mAlgorithm = Algorithm::EXPECTED_SIZE;
+
     // The first guess here
-    if (mPossibles.size() == mCodes.size) {
-        unsigned char answer[] = {0, 1, 2, 3, 4};
-        if (mSameColors) {
-            switch (mColors) {
-            case 2:
-                answer[2] = 0;
-                answer[3] = 1;
-                answer[2] = 0;
-                break;
-            case 3:
-                answer[3] = 1;
-                answer[4] = 2;
-                break;
-            default:
-                answer[3] = 2;
-                answer[4] = 3;
-                break;
-            }
-            // the classic game (c = 6, p = 4) is best with this first guess on Worst Case
-            if(mColors == 6 && mPegs == 4 && mAlgorithm == Algorithm::WORST_CASE) {
-                answer[2] = 0;
-                answer[3] = 1;
-            }
-        }
+    if (mPossibles.size() == mTables->size()) {
+        firstGuess(mAlgorithm, answer);
         permute(answer);
         mGuess->setGuess(mPegs, mColors, answer);
         return;
     }
 
     if (mPossibles.size() == 1) {
-        mGuess->setGuess(mPegs, mColors, mCodes.index[mPossibles.first()]);
+        mGuess->setGuess(mPegs, mColors, mTables->code(mPossibles.first()));
         return;
     }
 
-    if(mPossibles.size() > 10000) {
-        mGuess->setGuess(mPegs, mColors, mCodes.index[mPossibles.at(mPossibles.size() >> 1)]);
+    Symmetry symmetry;
+    QByteArray key;
+    if (mTranspositionTable) {
+        key = canonicalHistory(symmetry);
+        QByteArray canonical_guess;
+        qreal weight;
+        if (mTranspositionTable->find(key, canonical_guess, weight)) {
+            gameGuess(symmetry, canonical_guess, answer);
+            mGuess->setWeight(weight);
+            mGuess->setGuess(mPegs, mColors, answer);
+            return;
+        }
+    }
+
+    QVector<int> candidates;
+    if (mPossibles.size() <= mCalibration.exactLimit) {
+        TRACE_SCOPE("Solver::reduceCandidates", "solver");
+        METRICS(phase_timer.start();)
+        candidates = reduceCandidates();
+        METRICS(
+            mMetrics.reduceTime = phase_timer.nsecsElapsed()/1000;
+            mMetrics.prunedCandidates = mPrunedCandidates;
+        )
+    }
+
+    Engine engine = mEngine;
+    if (engine == Engine::AUTO)
+        engine = chooseEngine(candidates.size());
+    METRICS(mMetrics.engine = engine;)
+
+    if(engine == Engine::RANDOM || (mPossibles.size() > mCalibration.exactLimit && engine != Engine::SAMPLED)) {
+        mGuess->setGuess(mPegs, mColors, mTables->code(mPossibles.at(mPossibles.size() >> 1)));
         return;
     }
 
+    if (engine == Engine::SAMPLED)
+        candidates = sampleCandidates(candidates);
+
     int responsesOfCodes[mMaxResponse];
     for(int i = 0; i < mMaxResponse; ++i)
         responsesOfCodes[i] = 0;
@@ -241,29 +727,547 @@ void Solver::makeGuess()
     qreal min_code_weight = 1000000000;
     qreal code_weight;
 
-    for (int code_index = 0; code_index < mSmallPossibles.size; ++code_index) {
+    bool look_ahead = (engine == Engine::LOOKAHEAD && canLookAhead());
+    QList<QPair<qreal, int> > best; // the best candidates, sorted by weight
+
+    METRICS(phase_timer.start();)
+    for (int code_index = 0; code_index < candidates.size(); ++code_index) {
         if(mInterupt)
             return;
 
-        int whites, blacks;
-        foreach(int possible_index, mPossibles) {
-            COMPARE(mCodes.index[mSmallPossibles.index[code_index]], mCodes.index[possible_index], mColors, mPegs, blacks, whites);
-            ++responsesOfCodes[(blacks+whites)*(blacks+whites+1)/2 + blacks];
-        }
+        const int candidate = candidates.at(code_index);
+        foreach(int possible_index, mPossibles)
+            ++responsesOfCodes[mTables->response(candidate, possible_index)];
         code_weight = computeWeight(responsesOfCodes);
+        METRICS(
+            ++mMetrics.candidates;
+            mMetrics.comparisons += mPossibles.size();
+        )
 
         if (code_weight < min_code_weight) {
             answer_index = code_index;
             min_code_weight = code_weight;
         }
+
+        if (look_ahead) {
+            int position = best.size();
+            while (position > 0 && code_weight < best.at(position - 1).first)
+                --position;
+            if (position < LOOKAHEAD_WIDTH) {
+                best.insert(position, qMakePair(code_weight, code_index));
+                if (best.size() > LOOKAHEAD_WIDTH)
+                    best.removeLast();
+            }
+        }
+    }
+
+    METRICS(mMetrics.scoreTime = phase_timer.nsecsElapsed()/1000;)
+
+    if (look_ahead && best.size() > 1) {
+        QVector<int> best_codes;
+        for(int i = 0; i < best.size(); ++i)
+            best_codes.append(candidates.at(best.at(i).second));
+        METRICS(phase_timer.start();)
+        int chosen = lookAhead(best_codes);
+        METRICS(
+            mMetrics.lookAheadTime = phase_timer.nsecsElapsed()/1000;
+            // the follow up responses and the parts of the best candidates
+            mMetrics.comparisons += (qint64) (mSmallPossibles.size + best_codes.size())*mPossibles.size();
+        )
+        if (mInterupt)
+            return;
+        answer_index = best.at(chosen).second;
+        min_code_weight = best.at(chosen).first;
     }
 
     if(mAlgorithm == Algorithm::MOST_PARTS)
         min_code_weight = mMaxResponse - 2 - min_code_weight;
 
-    mGuess->setWeight(qFloor(min_code_weight));
+    qreal weight;
+    if (mAlgorithm == Algorithm::ENTROPY) {
+        // the entropy in bits: log2(N) - sum(n*log2(n))/N
+        qreal entropy = qLn(mPossibles.size())/qLn(2.0) - min_code_weight/(CodeTables::ENTROPY_SCALE*mPossibles.size());
+        weight = qRound(100*entropy)/100.0;
+    } else {
+        weight = qFloor(min_code_weight);
+    }
+
+    // a sampled guess depends on the speed of the machine, it is not kept
+    if (mTranspositionTable && engine != Engine::SAMPLED)
+        mTranspositionTable->insert(key, canonicalGuess(symmetry, mTables->code(candidates.at(answer_index))), weight);
+
+    mGuess->setWeight(weight);
+    mGuess->setGuess(mPegs, mColors, mTables->code(candidates.at(answer_index)));
+}
+
+int Solver::codeKey(const unsigned char* code) const
+{
+    int key = 0;
+    for(int i = 0; i < mPegs; ++i)
+        key = key*mColors + code[i];
+    return key;
+}
+
+void Solver::findSymmetries()
+{
+    mSymmetries.clear();
+    Symmetry symmetry;
+    for(int i = 0; i < mPegs; ++i)
+        symmetry.pegs[i] = i;
+
+    /*    A slot permutation fixes the history if there is a relabelling of
+     *    the played colors that maps every guess back to itself. Such a
+     *    relabelling is forced by the slot permutation, so we only need to
+     *    check all the slot permutations.
+     */
+    do {
+        unsigned char inverse[MAX_COLOR_NUMBER];
+        std::fill(symmetry.colors, symmetry.colors + MAX_COLOR_NUMBER, 255);
+        std::fill(inverse, inverse + MAX_COLOR_NUMBER, 255);
+        bool valid = true;
+        foreach(const Row& row, mHistory) {
+            for(int i = 0; i < mPegs && valid; ++i) {
+                unsigned char from = row.guess[symmetry.pegs[i]];
+                unsigned char to = row.guess[i];
+                if (symmetry.colors[from] == 255 && inverse[to] == 255) {
+                    symmetry.colors[from] = to;
+                    inverse[to] = from;
+                } else if (symmetry.colors[from] != to) {
+                    valid = false;
+                }
+            }
+        }
+        if (valid)
+            mSymmetries.append(symmetry);
+    } while (std::next_permutation(symmetry.pegs, symmetry.pegs + mPegs));
+}
+
+QVector<int> Solver::reduceCandidates()
+{
+    QVector<int> candidates;
+    candidates.reserve(mSmallPossibles.size);
+    mPrunedCandidates = 0;
+
+    /*    The colors of each class are interchangeable when weighting a
+     *    candidate. The colors that are not played yet are free, and the
+     *    colors that are not in any possible are dead. The other colors are
+     *    fixed, and can be only mapped by the symmetries of the history.
+     */
+    enum {FIXED = -1, FREE, DEAD, CLASSES};
+    int color_class[MAX_COLOR_NUMBER];
+    unsigned char class_colors[CLASSES][MAX_COLOR_NUMBER];
+    int class_size[CLASSES] = {0, 0};
+    for(int i = 0; i < mColors; ++i) {
+        if (!(mLiveColors & (1 << i)))
+            color_class[i] = DEAD;
+        else if (!(mPlayedColors & (1 << i)))
+            color_class[i] = FREE;
+        else
+            color_class[i] = FIXED;
+
+        if (color_class[i] != FIXED)
+            class_colors[color_class[i]][class_size[color_class[i]]++] = i;
+    }
+
+    findSymmetries();
+
+    if (mSymmetries.size() == 1 && class_size[FREE] < 2 && class_size[DEAD] < 2) {
+        for(int i = 0; i < mSmallPossibles.size; ++i)
+            candidates.append(mSmallPossibles.index[i]);
+        return candidates;
+    }
+
+    /*    Two equivalent candidates partition the possibles the same way, so
+     *    we evaluate only the first one. The canonical form of a code is its
+     *    smallest image, where the colors of each class are renamed in order
+     *    of appearance to the smallest colors of that class.
+     */
+    QVector<bool> seen(ipow(mColors, mPegs), false);
+    unsigned char image[MAX_SLOT_NUMBER];
+    unsigned char relabel[MAX_COLOR_NUMBER];
+    int next[CLASSES];
+    for(int code_index = 0; code_index < mSmallPossibles.size; ++code_index) {
+        const unsigned char* code = mTables->code(mSmallPossibles.index[code_index]);
+        int canonical = INT_MAX;
+        foreach(const Symmetry& symmetry, mSymmetries) {
+            std::fill(relabel, relabel + MAX_COLOR_NUMBER, 255);
+            std::fill(next, next + CLASSES, 0);
+            for(int i = 0; i < mPegs; ++i) {
+                unsigned char color = code[symmetry.pegs[i]];
+                if (mPlayedColors & (1 << color))
+                    color = symmetry.colors[color];
+                int color_class_ = color_class[color];
+                if (color_class_ == FIXED) {
+                    image[i] = color;
+                } else {
+                    if (relabel[color] == 255)
+                        relabel[color] = class_colors[color_class_][next[color_class_]++];
+                    image[i] = relabel[color];
+                }
+            }
+            canonical = qMin(canonical, codeKey(image));
+        }
+
+        if (!seen.at(canonical)) {
+            seen[canonical] = true;
+            candidates.append(mSmallPossibles.index[code_index]);
+        }
+    }
+
+    mPrunedCandidates = mSmallPossibles.size - candidates.size();
+    return candidates;
+}
+
+bool Solver::openingBookGuess(unsigned char* guess)
+{
+    if (!mOpeningBook)
+        return false;
+
+    // the auto engine uses the best tree of the book, and there is only
+    // one optimal tree for all the engines
+    Engine engine = (mEngine == Engine::AUTO) ? Engine::LOOKAHEAD : mEngine;
+    if (mAlgorithm == Algorithm::OPTIMAL)
+        engine = Engine::ONE_STEP;
+
+    if (mHistory.isEmpty()) {
+        mInBook = mOpeningBook->hasSection(mColors, mPegs, mSameColors, mAlgorithm, engine);
+        if (!mInBook)
+            return false;
+        for(int i = 0; i < MAX_SLOT_NUMBER; ++i)
+            mBookSymmetry.pegs[i] = i;
+        for(int i = 0; i < MAX_COLOR_NUMBER; ++i)
+            mBookSymmetry.colors[i] = i;
+        shuffle(mBookSymmetry.pegs, mPegs);
+        shuffle(mBookSymmetry.colors, mColors);
+    } else if (!mInBook) {
+        return false;
+    }
+
+    // the book is looked up by the history seen through the inverse symmetry
+    unsigned char inverse_colors[MAX_COLOR_NUMBER];
+    for(int i = 0; i < mColors; ++i)
+        inverse_colors[mBookSymmetry.colors[i]] = i;
+
+    QVector<unsigned char> guesses(mHistory.size()*mPegs);
+    QVector<int> responses;
+    for(int row = 0; row < mHistory.size(); ++row) {
+        const Row& history_row = mHistory.at(row);
+        for(int i = 0; i < mPegs; ++i)
+            guesses[row*mPegs + mBookSymmetry.pegs[i]] = inverse_colors[history_row.guess[i]];
+        int total = history_row.blacks + history_row.whites;
+        responses.append(total*(total + 1)/2 + history_row.blacks);
+    }
+
+    unsigned char book_guess[MAX_SLOT_NUMBER];
+    mInBook = mOpeningBook->find(mColors, mPegs, mSameColors, mAlgorithm, engine,
+                                 guesses, responses, book_guess);
+    if (!mInBook)
+        return false;
+
+    for(int i = 0; i < mPegs; ++i)
+        guess[i] = mBookSymmetry.colors[book_guess[mBookSymmetry.pegs[i]]];
+    return true;
+}
+
+QByteArray Solver::canonicalHistory(Symmetry& symmetry) const
+{
+    QByteArray key;
+    key.append((char) mColors);
+    key.append((char) mPegs);
+    key.append((char) mSameColors);
+    key.append((char) mAlgorithm);
+    key.append((char) mEngine);
+    // the limits decide the candidates and the look ahead, so a guess of other limits is not this one
+    for(int i = 0; i < 4; ++i)
+        key.append((char) (mCalibration.exactLimit >> 8*i));
+    for(int i = 0; i < 8; ++i)
+        key.append((char) (mCalibration.lookAheadBudget >> 8*i));
+
+    // for each slot permutation, the relabelling of the colors by their first
+    // appearance gives the least history; the canonical one is the least of all
+    unsigned char pegs[MAX_SLOT_NUMBER];
+    for(int i = 0; i < mPegs; ++i)
+        pegs[i] = i;
+
+    QByteArray best;
+    do {
+        unsigned char colors[MAX_COLOR_NUMBER];
+        std::fill(colors, colors + MAX_COLOR_NUMBER, 255);
+        int next_color = 0;
+        QByteArray rows;
+        foreach(const Row& row, mHistory) {
+            for(int i = 0; i < mPegs; ++i) {
+                unsigned char color = row.guess[pegs[i]];
+                if (colors[color] == 255)
+                    colors[color] = next_color++;
+                rows.append((char) colors[color]);
+            }
+            rows.append((char) row.blacks);
+            rows.append((char) row.whites);
+        }
+        if (best.isEmpty() || rows < best) {
+            best = rows;
+            array_copy(pegs, symmetry.pegs, mPegs);
+            array_copy(colors, symmetry.colors, MAX_COLOR_NUMBER);
+        }
+    } while (std::next_permutation(pegs, pegs + mPegs));
+
+    return key + best;
+}
+
+QByteArray Solver::canonicalGuess(const Symmetry& symmetry, const unsigned char* guess) const
+{
+    unsigned char colors[MAX_COLOR_NUMBER];
+    array_copy(symmetry.colors, colors, MAX_COLOR_NUMBER);
+    int next_color = 0;
+    for(int i = 0; i < mColors; ++i)
+        if (colors[i] != 255)
+            ++next_color;
+
+    QByteArray canonical_guess;
+    for(int i = 0; i < mPegs; ++i) {
+        unsigned char color = guess[symmetry.pegs[i]];
+        if (colors[color] == 255)
+            colors[color] = next_color++;
+        canonical_guess.append((char) colors[color]);
+    }
+    return canonical_guess;
+}
+
+void Solver::gameGuess(const Symmetry& symmetry, const QByteArray& canonical_guess, unsigned char* guess) const
+{
+    unsigned char inverse_colors[MAX_COLOR_NUMBER];
+    std::fill(inverse_colors, inverse_colors + MAX_COLOR_NUMBER, 255);
+    for(int i = 0; i < mColors; ++i)
+        if (symmetry.colors[i] != 255)
+            inverse_colors[symmetry.colors[i]] = i;
+
+    int free_color = 0;
+    for(int i = 0; i < mPegs; ++i) {
+        unsigned char color = canonical_guess.at(i);
+        if (inverse_colors[color] == 255) {
+            while (symmetry.colors[free_color] != 255)
+                ++free_color;
+            inverse_colors[color] = free_color++;
+        }
+        guess[symmetry.pegs[i]] = inverse_colors[color];
+    }
+}
+
+bool Solver::canLookAhead() const
+{
+    // the follow up responses are computed once, and then read by every best candidate
+    qint64 comparisons = (qint64) (LOOKAHEAD_WIDTH + 1)*mSmallPossibles.size*mPossibles.size();
+    return mPossibles.size() > 2 && comparisons <= mCalibration.lookAheadBudget;
+}
+
+int Solver::lookAhead(const QVector<int>& best)
+{
+    TRACE_SCOPE("Solver::lookAhead", "solver");
+    const int possibles_size = mPossibles.size();
+    const int followers_size = mSmallPossibles.size;
+
+    /*    The estimated number of guesses to find the code among n possibles,
+     *    after the follow up guess. One guess is enough for a single possible,
+     *    and a perfect split needs 2 - 1/n guesses on average.
+     */
+    QVector<qreal> estimates(possibles_size + 1);
+    estimates[0] = 0;
+    for(int n = 1; n <= possibles_size; ++n)
+        estimates[n] = (2.0*n - 1)/n + qMax(0.0, qLn(n)/qLn(mMaxResponse - 2.0) - 1);
+
+    // the responses of every follow up guess, shared by all the parts
+    QVector<unsigned char> responses(followers_size*possibles_size);
+    unsigned char* response_table = responses.data();
+    QVector<int> rows(followers_size);
+    for(int i = 0; i < followers_size; ++i)
+        rows[i] = i;
+
+    QtConcurrent::blockingMap(rows, [&](int& row) {
+        if (mInterupt)
+            return;
+        unsigned char* response = response_table + row*possibles_size;
+        const int follower = mSmallPossibles.index[row];
+        for(int j = 0; j < possibles_size; ++j)
+            response[j] = mTables->response(follower, mPossibles.at(j));
+    });
+
+    struct Part {
+        int candidate;
+        QVector<int> members;
+        qreal guesses;
+    };
+
+    QVector<Part> parts;
+    for(int candidate = 0; candidate < best.size(); ++candidate) {
+        QVector<QVector<int> > members(mMaxResponse);
+        for(int j = 0; j < possibles_size; ++j)
+            members[mTables->response(best.at(candidate), mPossibles.at(j))].append(j);
+        // the last response means the code is found, no more guesses needed
+        for(int i = 0; i < mMaxResponse - 1; ++i) {
+            if (!members.at(i).isEmpty()) {
+                Part part;
+                part.candidate = candidate;
+                part.members = members.at(i);
+                part.guesses = estimates.at(part.members.size());
+                parts.append(part);
+            }
+        }
+    }
+
+    QtConcurrent::blockingMap(parts, [&](Part& part) {
+        TRACE_SCOPE("lookAhead part", "worker");
+        int part_size = part.members.size();
+        if (part_size <= 2)
+            return;
+        QVector<int> sub_parts(mMaxResponse);
+        for(int row = 0; row < followers_size && !mInterupt; ++row) {
+            const unsigned char* response = response_table + row*possibles_size;
+            sub_parts.fill(0);
+            foreach(int member, part.members)
+                ++sub_parts[response[member]];
+            qreal guesses = 1;
+            for(int i = 0; i < mMaxResponse - 1; ++i)
+                guesses += sub_parts.at(i)*estimates.at(sub_parts.at(i))/part_size;
+            part.guesses = qMin(part.guesses, guesses);
+        }
+    });
+
+    QVector<qreal> expected_guesses(best.size(), 1);
+    foreach(const Part& part, parts)
+        expected_guesses[part.candidate] += part.members.size()*part.guesses/possibles_size;
+
+    int chosen = 0;
+    for(int candidate = 1; candidate < best.size(); ++candidate)
+        if (expected_guesses.at(candidate) < expected_guesses.at(chosen))
+            chosen = candidate;
+    return chosen;
+}
+
+qreal Solver::measureSpeed(const CodeTables& tables, const int& threads)
+{
+    // all the threads compare until the same deadline, a late thread only counts less
+    QVector<qint64> comparisons(threads, 0);
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(comparisons, [&](qint64& thread_comparisons) {
+        volatile int responses = 0; // keeps the comparisons from being optimized away
+        do {
+            for(int i = 0; i < 10000; ++i)
+                responses += tables.response(i % tables.size(), (i*7919) % tables.size());
+            thread_comparisons += 10000;
+        } while (timer.elapsed() < CALIBRATION_TIME);
+    });
+    const qint64 elapsed = qMax(timer.elapsed(), (qint64) 1);
+
+    qint64 total = 0;
+    foreach(qint64 thread_comparisons, comparisons)
+        total += thread_comparisons;
+    return total*1000.0/elapsed;
+}
+
+Solver::Calibration Solver::calibrate()
+{
+    // the codes of a big configuration do not fit in the cache, as in the long games
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(8, 5, true);
+    const int ideal_threads = QThread::idealThreadCount();
+    const int max_threads = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(ideal_threads);
+
+    // the first measure only warms up the caches and the clock of the core
+    measureSpeed(*tables, 1);
+    Calibration calibration;
+    calibration.comparisonsPerSecond = measureSpeed(*tables, 1);
+
+    // the fewest threads that give the speed, more threads only share the same cores
+    calibration.threads = 1;
+    qreal speed = calibration.comparisonsPerSecond;
+    for(int threads = 2; threads < 2*ideal_threads; threads *= 2) {
+        threads = qMin(threads, ideal_threads);
+        qreal threads_speed = measureSpeed(*tables, threads);
+        if (threads_speed > 1.25*speed) {
+            calibration.threads = threads;
+            speed = threads_speed;
+        }
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(max_threads);
+
+    /*    The candidates of a turn are at most the possibles, and the one step
+     *    engine weights them on one thread, so the square of the exact limit is
+     *    the comparisons of the turn. The look ahead runs on all the threads,
+     *    and it keeps a response for each comparison, which bounds its budget.
+     */
+    const qreal comparisons = calibration.comparisonsPerSecond*AUTO_LATENCY/1000;
+    calibration.exactLimit = qBound(2000, 1000*qRound(qSqrt(comparisons)/1000), 40000);
+    calibration.lookAheadBudget = qBound((qint64) 10000000, (qint64) (speed*AUTO_LATENCY/1000), (qint64) 400000000);
+    return calibration;
+}
+
+Solver::Calibration Solver::calibration()
+{
+    QMutexLocker locker(&calibrationMutex);
+    return sCalibration;
+}
+
+void Solver::setCalibration(const Calibration& calibration)
+{
+    QMutexLocker locker(&calibrationMutex);
+    sCalibration = calibration;
+    QThreadPool::globalInstance()->setMaxThreadCount(calibration.threads);
+}
 
-    mGuess->setGuess(mPegs, mColors, mCodes.index[mSmallPossibles.index[answer_index]]);
+void Solver::measureDefaultSpeed()
+{
+    QMutexLocker locker(&calibrationMutex);
+    if (sCalibration.comparisonsPerSecond == 0) {
+        QSharedPointer<const CodeTables> tables = CodeTables::acquire(8, 5, true);
+        measureSpeed(*tables, 1);
+        sCalibration.comparisonsPerSecond = measureSpeed(*tables, 1);
+    }
+}
+
+Engine Solver::chooseEngine(const int& candidates_size)
+{
+    if (mCalibration.comparisonsPerSecond == 0) {
+        // only a solver that is not calibrated or measured up front gets here
+        measureDefaultSpeed();
+        mCalibration.comparisonsPerSecond = calibration().comparisonsPerSecond;
+    }
+
+    const qreal budget = mCalibration.comparisonsPerSecond*AUTO_LATENCY/1000;
+    const qreal possibles_size = mPossibles.size();
+    const qreal one_step = candidates_size*possibles_size;
+
+    Engine engine;
+    if (possibles_size > budget)
+        engine = Engine::RANDOM;
+    else if (candidates_size == 0 || one_step > budget)
+        engine = Engine::SAMPLED;
+    else if (canLookAhead() && one_step + (LOOKAHEAD_WIDTH + 1)*mSmallPossibles.size*possibles_size/
+             mCalibration.threads <= budget)
+        engine = Engine::LOOKAHEAD;
+    else
+        engine = Engine::ONE_STEP;
+
+    static const char* engine_names[] = {"one step", "look ahead", "auto", "sampled", "random"};
+    AUTO_ENGINE_LOG << "Auto engine, turn" << mHistory.size() + 1 << ":" << mPossibles.size() << "possibles,"
+                    << candidates_size << "candidates," << qRound64(mCalibration.comparisonsPerSecond)
+                    << "comparisons/s," << engine_names[static_cast<int>(engine)];
+    return engine;
+}
+
+QVector<int> Solver::sampleCandidates(const QVector<int>& candidates) const
+{
+    const qreal budget = mCalibration.comparisonsPerSecond*AUTO_LATENCY/1000;
+    int sample_size = qMax(1, (int) (budget/mPossibles.size()));
+    int size = candidates.isEmpty() ? mPossibles.size() : candidates.size();
+
+    QVector<int> sample;
+    for(int i = 0; i < sample_size && i < size; ++i) {
+        int index = (int) ((qint64) i*size/qMin(sample_size, size));
+        sample.append(candidates.isEmpty() ? mPossibles.at(index) : candidates.at(index));
+    }
+    return sample;
 }
 
 qreal Solver::computeWeight(int* m_responses) const
@@ -273,7 +1277,7 @@ qreal Solver::computeWeight(int* m_responses) const
     switch (mAlgorithm) {
     case Algorithm::EXPECTED_SIZE:
         for(int i = 0; i < mMaxResponse-2; ++i) {
-            answer += ipow(m_responses[i], 2);
+            answer += (qreal) m_responses[i]*m_responses[i];
             m_responses[i] = 0;
         }
         break;
@@ -283,6 +1287,13 @@ qreal Solver::computeWeight(int* m_responses) const
             m_responses[i] = 0;
         }
         break;
+    case Algorithm::ENTROPY:
+        // maximizing the entropy is minimizing the sum of n*log(n) over the parts
+        for(int i = 0; i < mMaxResponse-2; ++i) {
+            answer += mTables->entropy(m_responses[i]);
+            m_responses[i] = 0;
+        }
+        break;
     default:    //    Most Parts
         for(int i = 0; i < mMaxResponse-2; ++i) {
             if (m_responses[i] == 0)
@@ -298,7 +1309,7 @@ qreal Solver::computeWeight(int* m_responses) const
         answer -= 0.5;
         if (mAlgorithm == Algorithm::MOST_PARTS)
             --answer;
-        else
+        else if (mAlgorithm != Algorithm::ENTROPY)
             ++answer;
 
         m_responses[mMaxResponse - 1] = 0;
@@ -307,41 +1318,6 @@ qreal Solver::computeWeight(int* m_responses) const
     return answer;
 }
 
-void Solver::nextCodeSameColor(unsigned char* X)
-{
-    int i = mPegs - 1;
-    int N = mColors;
-    N--;
-    while (i >= 0 && X[i] >= N)
-        X[i--] = 0;
-    if (i < 0) return;
-    X[i]++;
-}
-
-void Solver::nextCodeDifferentColor(unsigned char* X)
-{
-    int i = mPegs;
-    while (--i >= 0) {
-        while (++X[i] < mColors) {
-            int j = 0;
-            while (j < i && X[j] != X[i])
-                ++j;
-            if (j == i) goto mark;
-        }
-    }
-    return;
-mark:
-    while (++i < mPegs) {
-        X[i] = -1;
-        while (++X[i] < mColors) {
-            int j = 0;
-            while (j < i && X[j] != X[i])
-                ++j;
-            if (j == i) break;
-        }
-    }
-}
-
 QString Solver::arrayToString(const unsigned char* m_array) const
 {
     QString answer = "";
@@ -21,9 +21,13 @@
 #define SOLVER_H
 
 #include <QList>
+#include <QVector>
 #include <QThread>
 #include "appinfo.h"
+#include "codetables.h"
 class Guess;
+class OpeningBook;
+class TranspositionTable;
 
 /**    @brief The class Solver is the solving engine of the mastermind game. It contains all the solving
  *    algorithms and auxiliary functions that provide efficient code guess and handling
@@ -62,6 +66,76 @@ public:
     */
     static int ipow(int base, int exp);
 
+    /**
+    * @brief The Calibration struct
+    * The limits of the solver that fit the speed of the machine
+    */
+    struct Calibration {
+        qreal comparisonsPerSecond; /**< the speed of one thread, 0 if not measured yet */
+        int threads; /**< the number of threads of the parallel searches */
+        int exactLimit; /**< the most possibles that are weighted, more get a random guess */
+        qint64 lookAheadBudget; /**< the maximum comparisons of a look ahead */
+    };
+
+    /**
+    * @brief The Metrics struct
+    * What the last filter and the last guess cost. They are counted only when
+    * QTMIND_METRICS is defined (qmake CONFIG+=qtmind_metrics), and are zero otherwise
+    */
+    struct Metrics {
+        qint64 candidates; /**< the candidates weighted by the last guess */
+        int prunedCandidates; /**< the candidates skipped as equivalent to a weighted one */
+        qint64 comparisons; /**< the code comparisons of the last guess, including the look ahead */
+        qint64 filterTime; /**< the time of the last filter of the possibles, in microseconds */
+        qint64 reduceTime; /**< the time of reducing the candidates, in microseconds */
+        qint64 scoreTime; /**< the time of weighting the candidates, in microseconds */
+        qint64 lookAheadTime; /**< the time of the look ahead, in microseconds */
+        Engine engine; /**< the engine of the last guess, as chosen by the auto engine */
+        /**
+         * @brief comparisonsPerSecond the speed of the last guess
+         * @return qreal the comparisons per second, 0 if nothing was compared
+         */
+        qreal comparisonsPerSecond() const
+        {
+            const qint64 time = reduceTime + scoreTime + lookAheadTime;
+            return (time > 0) ? comparisons*1000000.0/time : 0;
+        }
+    };
+
+    /**
+     * @brief calibrate measure the speed of the machine for one and more threads,
+     * and find the limits that fit the target latency of a turn
+     * @return Calibration the limits of this machine
+     */
+    static Calibration calibrate();
+    /**
+     * @brief calibration the limits of all the solvers
+     */
+    static Calibration calibration();
+    /**
+     * @brief setCalibration set the limits of all the solvers, and the threads
+     * of the global pool. A solver takes the limits at reset, so they apply
+     * from its next game
+     */
+    static void setCalibration(const Calibration& calibration);
+    /**
+     * @brief measureDefaultSpeed measure the speed of one thread, if the machine
+     * is not calibrated. The tools call it before they start their threads, so
+     * that the speed is measured once and not under their load
+     */
+    static void measureDefaultSpeed();
+    /**
+     * @brief hasMetrics are the metrics counted in this build?
+     */
+    static bool hasMetrics()
+    {
+#ifdef QTMIND_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
     explicit Solver(Guess* guess, QObject* parent = 0);
 
     ~Solver();
@@ -74,6 +148,18 @@ public:
      */
     bool setResponse(const int& blacks, const int& whites, const unsigned char* guess);
 
+    /**
+     * @brief setHistory replace the game history, and keep the codes that satisfy
+     * every row in one parallel pass, instead of one pass for each row. The
+     * candidates are the possibles of the first rows that fall under the exact
+     * limit, as if the responses were set one by one
+     * @param guesses the played guesses, pegs colors for each guess
+     * @param responses the response index of each played guess
+     * @return true if some code satisfies the history, false if none does or a
+     * color or a response is out of range
+     */
+    bool setHistory(const QVector<unsigned char>& guesses, const QVector<int>& responses);
+
     /**
      * @brief run method of the thread
      *
@@ -95,8 +181,83 @@ public:
     /**
      * @brief startGuessing start the guessing process
      * @param alg the guessing algorithm
+     * @param engine the solving engine
+     */
+    void startGuessing(const Algorithm& alg, const Engine& engine = Engine::ONE_STEP);
+    /**
+     * @brief prunedCandidates the number of candidates skipped in the last guess
+     * because they are equivalent to an already evaluated candidate
+     * @return the number of pruned candidates
+     */
+    int prunedCandidates() const {return mPrunedCandidates;}
+    /**
+     * @brief metrics what the last filter and the last guess cost, to be read
+     * when the thread is not running
+     * @return Metrics the metrics, all zero if they are not counted
+     */
+    Metrics metrics() const {return mMetrics;}
+    /**
+     * @brief exactLimit the most possibles that are weighted in this game
+     */
+    int exactLimit() const {return mCalibration.exactLimit;}
+    /**
+     * @brief setOpeningBook set the book to be looked up before any search
+     * @param book the opening book, 0 for no book
+     */
+    void setOpeningBook(OpeningBook* book) {mOpeningBook = book;}
+    /**
+     * @brief setTranspositionTable set the table of the guesses of the previous games
+     * @param table the transposition table, 0 for no table
+     */
+    void setTranspositionTable(TranspositionTable* table) {mTranspositionTable = table;}
+    /**
+     * @brief firstGuess the first guess of the current configuration, before
+     * the random shuffling of its pegs and colors
+     * @param alg the guessing algorithm
+     * @param guess the first guess
+     */
+    void firstGuess(const Algorithm& alg, unsigned char* guess) const;
+    /**
+     * @brief saveState the configuration, the game history and the possibles,
+     * one bit for each code
+     * @return QByteArray the state of the solver
+     */
+    QByteArray saveState() const;
+    /**
+     * @brief restoreState restore a saved state, without filtering the codes again
+     * @param state the state of saveState
+     * @return true if the state is valid, false otherwise
+     */
+    bool restoreState(const QByteArray& state);
+    /**
+     * @brief undoResponse take back the last response, the possibles before it
+     * are restored without filtering the codes
+     * @return true if there was a response to undo, false otherwise
+     */
+    bool undoResponse();
+    /**
+     * @brief redoResponse put back the last undone response
+     * @param blacks the blacks of the response
+     * @param whites the whites of the response
+     * @return true if there was a response to redo, false otherwise
+     */
+    bool redoResponse(int& blacks, int& whites);
+    bool canUndo() const {return mSnapshot > 0;}
+    bool canRedo() const {return mSnapshot + 1 < mSnapshots.size();}
+    /**
+     * @brief startLocating find in the background the rows whose responses, if
+     * changed, make the game history consistent with a contradictory response
+     * @param blacks the blacks of the contradictory response
+     * @param whites the whites of the contradictory response
+     * @param guess the guess of the contradictory response
+     */
+    void startLocating(const int& blacks, const int& whites, const unsigned char* guess);
+    /**
+     * @brief suspectRows the rows found by the last locating, the row of the
+     * contradictory response is the one after the history
+     * @return QList<int> the rows, from the first one
      */
-    void startGuessing(const Algorithm& alg);
+    QList<int> suspectRows() const {return mSuspectRows;}
 
 signals:
 
@@ -104,8 +265,14 @@ signals:
      * @brief the guess done signal, to be emited when the process of guessing finished
      */
     void guessDoneSignal();
+    /**
+     * @brief the locating done signal, to be emited when the suspect rows are found
+     */
+    void locatingDoneSignal();
 
 private:
+    struct Symmetry;
+
     /**
      * @brief makeGuess make the guess
      */
@@ -141,34 +308,145 @@ private:
          */
     qreal computeWeight(int* m_responses) const;
     /**
-     * @brief find the next code of a code when same color is allowed
-     * @param X the code
-         */
-    void nextCodeSameColor(unsigned char* X);
+     * @brief set the small set of possibles under 10_000
+     */
+    void setSmallPossibles();
     /**
-     * @brief find the next code of a code when same color is not allowed
-     * @param X the code
+     * @brief the key of a code, a number in base mColors
+     * @param code the code
+     * @return int the key of the code
      */
-    void nextCodeDifferentColor(unsigned char* X);
+    int codeKey(const unsigned char* code) const;
     /**
-     * @brief set the small set of possibles under 10_000
+     * @brief find all the slot permutations and color relabellings that fix
+     * every guess played so far
      */
-    void setSmallPossibles();
+    void findSymmetries();
+    /**
+     * @brief reduceCandidates keep one representative of each class of
+     * candidates which are equivalent under the symmetries of the game history
+     * and the relabelling of free and dead colors
+     * @return the code indices of the representatives
+     */
+    QVector<int> reduceCandidates();
+    /**
+     * @brief canLookAhead is the two plies search affordable for the current possibles?
+     * @return true if the look ahead fits the time budget, false otherwise
+     */
+    bool canLookAhead() const;
+    /**
+     * @brief lookAhead choose among the best candidates by the expected number of
+     * guesses, where every part is followed by its best follow up guess
+     * @param best the code indices of the best candidates by their weights
+     * @return int the index of the chosen candidate in best
+     */
+    int lookAhead(const QVector<int>& best);
+    /**
+     * @brief measure the number of code comparisons per second on this machine
+     * @param tables the tables whose codes are compared
+     * @param threads the number of threads comparing at the same time
+     * @return qreal the comparisons per second of all the threads
+     */
+    static qreal measureSpeed(const CodeTables& tables, const int& threads);
+    /**
+     * @brief chooseEngine choose the best engine whose estimated cost fits the
+     * turn latency, by the comparisons per second of the machine
+     * @param candidates_size the number of candidates to be weighted
+     * @return Engine the chosen engine
+     */
+    Engine chooseEngine(const int& candidates_size);
+    /**
+     * @brief sampleCandidates take evenly spaced candidates, so that weighting
+     * them fits the turn latency
+     * @param candidates the candidates, or the possibles if empty
+     * @return QVector<int> the code indices of the sampled candidates
+     */
+    QVector<int> sampleCandidates(const QVector<int>& candidates) const;
+    /**
+     * @brief openingBookGuess look up the game history in the opening book
+     * @param guess the guess of the book
+     * @return true if the history is in the book, false otherwise
+     */
+    bool openingBookGuess(unsigned char* guess);
+    /**
+     * @brief canonicalHistory the game history up to slot permutations and
+     * color relabellings, together with the configuration and the algorithm
+     * @param symmetry the symmetry that maps the game to its canonical form
+     * @return QByteArray the key of the history in the transposition table
+     */
+    QByteArray canonicalHistory(Symmetry& symmetry) const;
+    /**
+     * @brief canonicalGuess map a guess to the canonical form of the game
+     * @param symmetry the symmetry of canonicalHistory
+     * @param guess the guess
+     * @return QByteArray the canonical guess
+     */
+    QByteArray canonicalGuess(const Symmetry& symmetry, const unsigned char* guess) const;
+    /**
+     * @brief gameGuess map a canonical guess back to the game, the colors
+     * that are not played yet are interchangeable
+     * @param symmetry the symmetry of canonicalHistory
+     * @param canonical_guess the canonical guess
+     * @param guess the guess
+     */
+    void gameGuess(const Symmetry& symmetry, const QByteArray& canonical_guess, unsigned char* guess) const;
+    /**
+     * @brief locate find the suspect rows of the contradictory response
+     */
+    void locate();
 
 private:
 
     /**
-    * @brief The Codes struct
-    * All codes
+    * @brief The Row struct
+    * A played guess and its response
     */
-    struct Codes {
-        int size;
-        unsigned char** index;
-    } mCodes;
+    struct Row {
+        unsigned char guess[MAX_SLOT_NUMBER];
+        int blacks;
+        int whites;
+    };
+
+    /**
+    * @brief The Snapshot struct
+    * The state of the solver after a row, to undo and redo the responses
+    */
+    struct Snapshot {
+        Row row; /**< the row that leads to this state */
+        QList<int> possibles; /**< shared with the solver, so taking it copies nothing */
+        int playedColors;
+        int liveColors;
+        bool inBook;
+        bool smallPossibles; /**< are the candidates set in this state? */
+    };
+
+    /**
+     * @brief takeSnapshot the current state of the solver
+     */
+    Snapshot takeSnapshot() const;
+    /**
+     * @brief restoreSnapshot go back or forth to a state of the solver
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
+    /**
+    * @brief The Symmetry struct
+    * A slot permutation together with a color relabelling. It maps the code
+    * X to the code Y, where Y[i] = colors[X[pegs[i]]]
+    */
+    struct Symmetry {
+        unsigned char pegs[MAX_SLOT_NUMBER];
+        unsigned char colors[MAX_COLOR_NUMBER];
+    };
+
+    static Calibration sCalibration; /**< the limits of all the solvers */
+    Calibration mCalibration; /**< the limits of this game, taken from sCalibration at reset */
+
+    QSharedPointer<const CodeTables> mTables; /**< all codes, shared by the solvers of the same configuration */
 
     /**
     * @brief The FirstPossiblesUnder10_000 struct
-    * The first possibles codes under ten thousands
+    * The first possibles codes under the exact limit, ten thousands by default
     */
     struct FirstPossiblesUnder10_000 {
         int size;
@@ -179,10 +457,28 @@ private:
     int mColors; /**< the number of colors */
     bool mSameColors; /**< same color allowed flag */
     Algorithm mAlgorithm; /**< the solving algorithm */
+    Engine mEngine; /**< the solving engine */
     int mMaxResponse; /**< maximum number of responses */
     volatile bool mInterupt; /**< the interupt flag */
     QList<int> mPossibles;   /**<    list of all possibles */
+    QList<Row> mHistory; /**< the guesses played so far */
+    QList<Symmetry> mSymmetries; /**< the symmetries of the game history */
+    int mPrunedCandidates; /**< the number of candidates pruned in the last guess */
+    Metrics mMetrics; /**< the cost of the last filter and the last guess */
+    int mPlayedColors; /**< bitmask of the colors played so far */
+    int mLiveColors; /**< bitmask of the colors that appear in some possible */
     Guess* mGuess; /**< the guess element */
+    OpeningBook* mOpeningBook; /**< the opening book */
+    TranspositionTable* mTranspositionTable; /**< the guesses of the previous games */
+    bool mInBook; /**< is the game still in the opening book? */
+    Symmetry mBookSymmetry; /**< maps the book to the game, so that the games are not all the same */
+    QList<Snapshot> mSnapshots; /**< the states after each row, including the undone ones */
+    int mSnapshot; /**< the index of the current state in mSnapshots */
+    bool mLocating; /**< is the thread locating instead of guessing? */
+    Row mLocatingRow; /**< the contradictory response to be located */
+    QList<int> mSuspectRows; /**< the rows found by the last locating */
+
+    friend class SolverBenchmark;
 };
 
 #endif // SOLVER_H
@@ -17,6 +17,7 @@
  *
  ***********************************************************************/
 #include "sounds.h"
+#include "tracer.h"
 #include <QSettings>
 #if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
 #include <QtMultimedia/QSoundEffect>
@@ -32,13 +33,22 @@ struct QSoundEffect {
 
 Sounds::Sounds(QObject* parent): QObject(parent)
 {
+    // the effects are decoded by load, after the first frame
+    setVolume(QSettings().value("Volume", 3).toInt());
+}
+
+void Sounds::load()
+{
+    TRACE_SCOPE("Sounds::load", "game");
+    if (mPegDrop)
+        return;
     mPegDrop =  QSharedPointer<QSoundEffect>(new QSoundEffect, &QSoundEffect::deleteLater);
     mPegDropRefuse =  QSharedPointer<QSoundEffect>(new QSoundEffect, &QSoundEffect::deleteLater);
     mButtonPress =  QSharedPointer<QSoundEffect>(new QSoundEffect, &QSoundEffect::deleteLater);
     mPegDrop.data()->setSource(QUrl::fromLocalFile("://sounds/resources/sounds/pegdrop.wav"));
     mPegDropRefuse.data()->setSource(QUrl::fromLocalFile("://sounds/resources/sounds/pegrefuse.wav"));
     mButtonPress.data()->setSource(QUrl::fromLocalFile("://sounds/resources/sounds/pin.wav"));
-    setVolume(QSettings().value("Volume", 3).toInt());
+    setVolume(static_cast<int>(mVolume));
 }
 
 Sounds::~Sounds()
@@ -49,6 +59,8 @@ Sounds::~Sounds()
 void Sounds::setVolume(const int& vol)
 {
     mVolume = static_cast<Volume>(vol);
+    if (!mPegDrop)
+        return;
     qreal real_volume = static_cast<qreal>(mVolume)/3;
     mPegDrop.data()->setVolume(real_volume);
     mPegDropRefuse.data()->setVolume(real_volume);
@@ -62,16 +74,19 @@ Volume Sounds::volume() const
 
 void Sounds::onPegDroped()
 {
-    mPegDrop.data()->play();
+    if (mPegDrop)
+        mPegDrop.data()->play();
 }
 
 void Sounds::onPegDropRefused()
 {
-    mPegDropRefuse.data()->play();
+    if (mPegDropRefuse)
+        mPegDropRefuse.data()->play();
 }
 
 void Sounds::onButtonPressed()
 {
-    mButtonPress.data()->play();
+    if (mButtonPress)
+        mButtonPress.data()->play();
 }
 
@@ -32,6 +32,10 @@ public:
     explicit Sounds(QObject* parent = 0);
     ~Sounds();
 
+    /**
+     * @brief load decode the sound effects, they are silent before it
+     */
+    void load();
     void setVolume(const int& vol);
     Volume volume() const;
 
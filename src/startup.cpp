@@ -0,0 +1,57 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "startup.h"
+#include <QElapsedTimer>
+
+qint64 Startup::sFirstFrame = -1;
+qint64 Startup::sDeferred = -1;
+
+static QElapsedTimer sTimer; /**< The clock from the beginning of main */
+
+void Startup::start()
+{
+    sTimer.start();
+    sFirstFrame = -1;
+    sDeferred = -1;
+}
+
+void Startup::firstFrameShown()
+{
+    if (sFirstFrame >= 0 || !sTimer.isValid())
+        return;
+    sFirstFrame = sTimer.elapsed();
+    if (sFirstFrame > budget())
+        qWarning("the first frame is shown in %lld ms, over the budget of %d ms", sFirstFrame, budget());
+}
+
+void Startup::deferredDone()
+{
+    if (sDeferred < 0 && sTimer.isValid())
+        sDeferred = sTimer.elapsed();
+}
+
+int Startup::budget()
+{
+#ifdef Q_OS_ANDROID
+    return ANDROID_BUDGET;
+#else
+    return DESKTOP_BUDGET;
+#endif
+}
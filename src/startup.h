@@ -0,0 +1,72 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QtGlobal>
+
+/**    @brief The class Startup times the start of the application: from the
+ *    beginning of main to the first frame of the board, and to the end of the
+ *    work that is deferred after the first frame, the language menu, the sound
+ *    effects, the calibration of the first run and the solver. The time to the
+ *    first frame has a budget on each platform, a slower start is warned.
+ */
+class Startup
+{
+public:
+
+    static const int DESKTOP_BUDGET = 500; /**< the time to the first frame on the desktop in milliseconds */
+    static const int ANDROID_BUDGET = 1500; /**< the time to the first frame on Android in milliseconds */
+
+    /**
+     * @brief start start the clock, first thing in main
+     */
+    static void start();
+    /**
+     * @brief firstFrameShown record the time of the first frame
+     */
+    static void firstFrameShown();
+    /**
+     * @brief deferredDone record the time of the end of the deferred work
+     */
+    static void deferredDone();
+    /**
+     * @brief firstFrame the time to the first frame
+     * @return qint64 in milliseconds, -1 if it is not shown yet
+     */
+    static qint64 firstFrame() {return sFirstFrame;}
+    /**
+     * @brief deferred the time to the end of the deferred work
+     * @return qint64 in milliseconds, -1 if it is not done yet
+     */
+    static qint64 deferred() {return sDeferred;}
+    /**
+     * @brief budget the budget of the first frame on this platform
+     * @return int in milliseconds
+     */
+    static int budget();
+    static bool isWithinBudget() {return sFirstFrame >= 0 && sFirstFrame <= budget();}
+
+private:
+    static qint64 sFirstFrame; /**< in milliseconds, -1 if not shown yet */
+    static qint64 sDeferred; /**< in milliseconds, -1 if not done yet */
+};
+
+#endif // STARTUP_H
@@ -28,6 +28,19 @@ Tools::Tools()
     mAutoCloseRows = settings.value("AutoCloseRows", false).toBool();
     mLocale = QLocale(QSettings().value("Locale/Language", "en").toString().left(5));
     mLocale.setNumberOptions(QLocale::OmitGroupSeparator);
+
+    // the machine is calibrated after the first frame of the first run, and
+    // then on demand
+    mCalibrated = settings.contains("Calibration/Threads");
+    if (mCalibrated) {
+        mCalibration.comparisonsPerSecond = settings.value("Calibration/ComparisonsPerSecond", 0).toDouble();
+        mCalibration.threads = qMax(1, settings.value("Calibration/Threads").toInt());
+        mCalibration.exactLimit = settings.value("Calibration/ExactLimit", 10000).toInt();
+        mCalibration.lookAheadBudget = settings.value("Calibration/LookAheadBudget", 100000000).toLongLong();
+        Solver::setCalibration(mCalibration);
+    } else {
+        mCalibration = Solver::calibration();
+    }
 }
 
 Tools::~Tools()
@@ -38,5 +51,22 @@ Tools::~Tools()
     settings.setValue("AutoPutPins",    mAutoPutPins);
     settings.setValue("AutoCloseRows", mAutoCloseRows);
     QSettings().setValue("Locale/Language", mLocale.name());
+    if (!mCalibrated)
+        return;
+    settings.setValue("Calibration/ComparisonsPerSecond", mCalibration.comparisonsPerSecond);
+    settings.setValue("Calibration/Threads", mCalibration.threads);
+    settings.setValue("Calibration/ExactLimit", mCalibration.exactLimit);
+    settings.setValue("Calibration/LookAheadBudget", mCalibration.lookAheadBudget);
+}
+
+void Tools::calibrate()
+{
+    setCalibration(Solver::calibrate());
 }
 
+void Tools::setCalibration(const Solver::Calibration& calibration)
+{
+    mCalibration = calibration;
+    Solver::setCalibration(mCalibration);
+    mCalibrated = true;
+}
@@ -21,6 +21,7 @@
 
 #include <QString>
 #include <QLocale>
+#include "solver.h"
 
 /**
  * @brief The Tools class provides board tools to be used in a game.
@@ -31,16 +32,30 @@ public:
     Tools();
     ~Tools();
 
+private:
+    /**
+     * @brief calibrate measure the limits of the solver on this machine
+     */
+    void calibrate();
+    /**
+     * @brief setCalibration keep the limits that are measured on this machine,
+     * and set them to the solver
+     */
+    void setCalibration(const Solver::Calibration& calibration);
+
 private:
     QString mFontName; /**< TODO */
     int mFontSize; /**< TODO */
     bool mAutoPutPins; /**< TODO */
     bool mAutoCloseRows; /**< TODO */
     QLocale mLocale;
+    Solver::Calibration mCalibration; /**< the limits of the solver on this machine */
+    bool mCalibrated; /**< is the machine calibrated? the default limits are used before */
 
     friend class Game;
     friend class MainWindow;
     friend class Preferences;
+    friend class GuiBenchmark;
 };
 
 #endif // TOOLS_H
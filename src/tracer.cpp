@@ -0,0 +1,151 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+static const int MAX_EVENTS = 1000000; /**< The most recorded events, the later ones are dropped */
+
+std::atomic<bool> Tracer::sEnabled(false);
+
+/**
+* @brief The TraceEvent struct
+* A complete event of a thread
+*/
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    qint64 begin; /**< in microseconds */
+    qint64 duration; /**< in microseconds */
+    int thread; /**< the index of the thread */
+};
+
+/**
+* @brief The TraceData struct
+* The events and the threads recorded so far
+*/
+struct TraceData {
+    QMutex mutex;
+    QElapsedTimer timer;
+    QString fileName;
+    QVector<TraceEvent> events;
+    QHash<Qt::HANDLE, int> threads; /**< the index of each thread, in order of their first event */
+    QHash<int, QString> threadNames;
+
+    int threadIndex()
+    {
+        Qt::HANDLE handle = QThread::currentThreadId();
+        QHash<Qt::HANDLE, int>::const_iterator it = threads.constFind(handle);
+        if (it != threads.constEnd())
+            return it.value();
+        const int index = threads.size();
+        threads.insert(handle, index);
+        return index;
+    }
+};
+
+Q_GLOBAL_STATIC(TraceData, sTraceData)
+
+/**
+ * @brief escaped a string in a JSON string
+ */
+static QByteArray escaped(const QString& text)
+{
+    QByteArray result;
+    foreach(QChar c, text) {
+        if (c == '"' || c == '\\')
+            result.append('\\');
+        if (c.unicode() >= 0x20)
+            result.append(QString(c).toUtf8());
+    }
+    return result;
+}
+
+void Tracer::start(const QString& file_name)
+{
+    TraceData* data = sTraceData();
+    QMutexLocker locker(&data->mutex);
+    data->fileName = file_name;
+    data->events.clear();
+    data->events.reserve(4096);
+    data->timer.start();
+    sEnabled.store(true, std::memory_order_release);
+}
+
+bool Tracer::stop()
+{
+    if (!sEnabled.exchange(false))
+        return true;
+
+    TraceData* data = sTraceData();
+    QMutexLocker locker(&data->mutex);
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QByteArray json("{\"traceEvents\":[\n");
+    QHash<int, QString>::const_iterator it;
+    for(it = data->threadNames.constBegin(); it != data->threadNames.constEnd(); ++it)
+        json.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%1,\"tid\":%2,\"args\":{\"name\":\"").
+                    arg(pid).arg(it.key()).toUtf8() + escaped(it.value()) + "\"}},\n");
+    foreach(const TraceEvent& event, data->events)
+        json.append(QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6},\n").
+                    arg(event.name).arg(event.category).arg(event.begin).arg(event.duration).
+                    arg(pid).arg(event.thread).toUtf8());
+    // the last event is followed by the process name, so that no comma is left
+    json.append(QString("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%1,\"args\":{\"name\":\"%2\"}}\n]}\n").
+                arg(pid).arg(QCoreApplication::applicationName()).toUtf8());
+    data->events.clear();
+
+    QFile file(data->fileName);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(json) == json.size();
+}
+
+void Tracer::setThreadName(const QString& name)
+{
+    if (!isEnabled())
+        return;
+    TraceData* data = sTraceData();
+    QMutexLocker locker(&data->mutex);
+    data->threadNames.insert(data->threadIndex(), name);
+}
+
+qint64 Tracer::now()
+{
+    return sTraceData()->timer.nsecsElapsed()/1000;
+}
+
+void Tracer::addEvent(const char* name, const char* category, const qint64& begin, const qint64& end)
+{
+    TraceData* data = sTraceData();
+    QMutexLocker locker(&data->mutex);
+    if (!isEnabled() || data->events.size() >= MAX_EVENTS)
+        return;
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.begin = begin;
+    event.duration = end - begin;
+    event.thread = data->threadIndex();
+    data->events.append(event);
+}
@@ -0,0 +1,102 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <atomic>
+
+/**    @brief The class Tracer records the time of the phases of the solver and
+ *    of the game, in any thread, and writes them as a Chrome trace event file,
+ *    to be opened by chrome://tracing or Perfetto. A phase is traced by a scope:
+ *
+ *          TRACE_SCOPE("makeGuess", "solver");
+ *
+ *    records the time from there to the end of the block. The tracer is
+ *    started by the --trace FILE option or the QTMIND_TRACE environment
+ *    variable. When it is not started, a scope only checks a flag.
+ */
+class Tracer
+{
+public:
+
+    /**
+    * @brief The Scope class
+    * Records a complete event from its construction to its destruction. The
+    * name and the category must be string literals, they are kept as pointers
+    */
+    class Scope
+    {
+    public:
+        Scope(const char* name, const char* category):
+            mName(name),
+            mCategory(category),
+            mBegin(isEnabled() ? now() : -1)
+        {
+        }
+        ~Scope()
+        {
+            if (mBegin >= 0)
+                addEvent(mName, mCategory, mBegin, now());
+        }
+
+    private:
+        const char* mName;
+        const char* mCategory;
+        qint64 mBegin; /**< the begin of the event in microseconds, -1 if not traced */
+    };
+
+    /**
+     * @brief start start recording the events
+     * @param file_name the trace file, written by stop
+     */
+    static void start(const QString& file_name);
+    /**
+     * @brief stop stop recording and write the trace file
+     * @return true if the file is written or the tracer was not started, false otherwise
+     */
+    static bool stop();
+    static bool isEnabled() {return sEnabled.load(std::memory_order_relaxed);}
+    /**
+     * @brief setThreadName name the current thread on the timeline
+     * @param name the name of the thread
+     */
+    static void setThreadName(const QString& name);
+
+private:
+    /**
+     * @brief now the time since the tracer was started
+     * @return qint64 the time in microseconds
+     */
+    static qint64 now();
+    static void addEvent(const char* name, const char* category, const qint64& begin, const qint64& end);
+
+private:
+    static std::atomic<bool> sEnabled; /**< is the tracer started? read by every scope of every thread */
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+/**
+ * @brief TRACE_SCOPE trace the rest of the block as a phase
+ */
+#define TRACE_SCOPE(name, category) Tracer::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name, category)
+
+#endif // TRACER_H
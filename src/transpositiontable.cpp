@@ -0,0 +1,191 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "transpositiontable.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSettings>
+#include <QVector>
+#include <algorithm>
+
+static const quint32 MAGIC = 0x514d5454; /**< "QMTT", the magic number of the table file */
+static const quint16 VERSION = 2; /**< the version of the table file */
+
+Q_GLOBAL_STATIC(TranspositionTable, sTranspositionTable)
+
+TranspositionTable::TranspositionTable():
+    mStamp(0),
+    mCapacity(DEFAULT_CAPACITY),
+    mChanged(false)
+{
+}
+
+TranspositionTable* TranspositionTable::instance()
+{
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    TranspositionTable* table = sTranspositionTable();
+    static bool loaded = false;
+    if (!loaded) {
+        loaded = true;
+        table->load();
+    }
+    return table;
+}
+
+bool TranspositionTable::find(const QByteArray& key, QByteArray& guess, qreal& weight)
+{
+    QMutexLocker locker(&mMutex);
+    QHash<QByteArray, Entry>::iterator it = mEntries.find(key);
+    if (it == mEntries.end())
+        return false;
+    it.value().stamp = ++mStamp;
+    guess = it.value().guess;
+    weight = it.value().weight;
+    return true;
+}
+
+void TranspositionTable::insert(const QByteArray& key, const QByteArray& guess, const qreal& weight)
+{
+    QMutexLocker locker(&mMutex);
+    Entry entry;
+    entry.guess = guess;
+    entry.weight = weight;
+    entry.stamp = ++mStamp;
+    mEntries.insert(key, entry);
+    mChanged = true;
+    if (mEntries.size() > mCapacity)
+        evict();
+}
+
+void TranspositionTable::setCapacity(const int& capacity)
+{
+    QMutexLocker locker(&mMutex);
+    mCapacity = qMax(1, capacity);
+    while (mEntries.size() > mCapacity)
+        evict();
+}
+
+bool TranspositionTable::load(const QString& file_name)
+{
+    QFile file(file_name.isEmpty() ? defaultFileName() : file_name);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    quint32 size;
+    in >> magic >> version >> size;
+    if (magic != MAGIC || version != VERSION)
+        return false;
+
+    QMutexLocker locker(&mMutex);
+    mEntries.clear();
+    mStamp = 0;
+    // the entries are saved from the oldest to the newest
+    for(quint32 i = 0; i < size && in.status() == QDataStream::Ok; ++i) {
+        QByteArray key;
+        Entry entry;
+        in >> key >> entry.guess >> entry.weight;
+        // a damaged entry is dropped, the solver reads its guess without checks
+        if (in.status() != QDataStream::Ok || !isValid(key, entry.guess))
+            continue;
+        entry.stamp = ++mStamp;
+        mEntries.insert(key, entry);
+    }
+    while (mEntries.size() > mCapacity)
+        evict();
+    mChanged = false;
+    return in.status() == QDataStream::Ok;
+}
+
+bool TranspositionTable::save(const QString& file_name)
+{
+    QMutexLocker locker(&mMutex);
+    if (!mChanged && file_name.isEmpty())
+        return true;
+
+    QString name = file_name.isEmpty() ? defaultFileName() : file_name;
+    QDir().mkpath(QFileInfo(name).absolutePath());
+    QFile file(name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QList<QPair<quint32, QByteArray> > order;
+    for(QHash<QByteArray, Entry>::const_iterator it = mEntries.constBegin(); it != mEntries.constEnd(); ++it)
+        order.append(qMakePair(it.value().stamp, it.key()));
+    std::sort(order.begin(), order.end());
+
+    QDataStream out(&file);
+    out << MAGIC << VERSION << (quint32) order.size();
+    for(int i = 0; i < order.size(); ++i) {
+        const Entry& entry = mEntries[order.at(i).second];
+        out << order.at(i).second << entry.guess << entry.weight;
+    }
+    if (out.status() != QDataStream::Ok)
+        return false;
+    mChanged = false;
+    return true;
+}
+
+QString TranspositionTable::defaultFileName()
+{
+    // the ini format, so that the directory is a real one on every platform
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       QCoreApplication::organizationName(), QCoreApplication::applicationName());
+    return QFileInfo(settings.fileName()).absolutePath() + "/qtmind.tt";
+}
+
+bool TranspositionTable::isValid(const QByteArray& key, const QByteArray& guess)
+{
+    if (key.size() < KEY_HEADER_SIZE)
+        return false;
+    const int colors = (quint8) key.at(0);
+    const int pegs = (quint8) key.at(1);
+    if (colors < MIN_COLOR_NUMBER || colors > MAX_COLOR_NUMBER || pegs < MIN_SLOT_NUMBER ||
+            pegs > MAX_SLOT_NUMBER || (key.size() - KEY_HEADER_SIZE) % (pegs + 2) != 0 || guess.size() != pegs)
+        return false;
+    for(int i = 0; i < pegs; ++i)
+        if ((quint8) guess.at(i) >= colors)
+            return false;
+    return true;
+}
+
+void TranspositionTable::evict()
+{
+    QVector<quint32> stamps;
+    stamps.reserve(mEntries.size());
+    foreach(const Entry& entry, mEntries)
+        stamps.append(entry.stamp);
+    QVector<quint32>::iterator cut = stamps.begin() + stamps.size()/4;
+    std::nth_element(stamps.begin(), cut, stamps.end());
+    const quint32 oldest = *cut;
+
+    QHash<QByteArray, Entry>::iterator it = mEntries.begin();
+    while (it != mEntries.end()) {
+        if (it.value().stamp <= oldest)
+            it = mEntries.erase(it);
+        else
+            ++it;
+    }
+}
@@ -0,0 +1,129 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include "appinfo.h"
+
+/**    @brief The class TranspositionTable keeps the guesses of the solver across
+ *    games. A guess is stored by the canonical form of the game history, the
+ *    history up to slot permutations and color relabellings, so the games that
+ *    reach the same solver state share it. The table is saved in the settings
+ *    directory and keeps the most recently used guesses up to its capacity.
+ *
+ *    A key begins with the colors, the pegs, same colors, the algorithm and the
+ *    engine, one byte each, the exact limit in four bytes and the look ahead
+ *    budget in eight, little endian, as the limits decide the guess. The rows
+ *    follow, the relabelled colors of each guess and its blacks and whites.
+ *    The guess has the relabelled colors, one for each peg.
+ */
+class TranspositionTable
+{
+public:
+
+    static const int DEFAULT_CAPACITY = 100000; /**< the default maximum number of entries */
+    static const int KEY_HEADER_SIZE = 17; /**< the bytes of a key before its rows */
+
+    TranspositionTable();
+
+    /**
+     * @brief instance the table of the application, loaded from the settings
+     * directory on the first call
+     * @return TranspositionTable* the table of the application
+     */
+    static TranspositionTable* instance();
+
+    /**
+     * @brief find find the guess of a canonical history
+     * @param key the canonical history
+     * @param guess the canonical guess
+     * @param weight the weight of the guess
+     * @return true if the history is in the table, false otherwise
+     */
+    bool find(const QByteArray& key, QByteArray& guess, qreal& weight);
+
+    /**
+     * @brief insert store the guess of a canonical history, evicting the least
+     * recently used entries if the table is full
+     * @param key the canonical history
+     * @param guess the canonical guess
+     * @param weight the weight of the guess
+     */
+    void insert(const QByteArray& key, const QByteArray& guess, const qreal& weight);
+
+    /**
+     * @brief setCapacity set the maximum number of entries
+     * @param capacity the maximum number of entries
+     */
+    void setCapacity(const int& capacity);
+
+    /**
+     * @brief load read the table from a file
+     * @param file_name the table file, the default one if empty
+     * @return true if the table is read, false otherwise
+     */
+    bool load(const QString& file_name = QString());
+
+    /**
+     * @brief save write the table to a file, if it is changed
+     * @param file_name the table file, the default one if empty
+     * @return true if the table is written, false otherwise
+     */
+    bool save(const QString& file_name = QString());
+
+private:
+    /**
+    * @brief The Entry struct
+    * A stored guess
+    */
+    struct Entry {
+        QByteArray guess;
+        qreal weight;
+        quint32 stamp; /**< the time of the last use */
+    };
+
+    /**
+     * @brief defaultFileName the table file in the settings directory
+     * @return QString the file name
+     */
+    static QString defaultFileName();
+    /**
+     * @brief isValid is an entry read from a file one of a game?
+     * @return true if the key and the guess fit the configuration of the key
+     */
+    static bool isValid(const QByteArray& key, const QByteArray& guess);
+    /**
+     * @brief evict remove the least recently used quarter of the entries
+     */
+    void evict();
+
+private:
+    QHash<QByteArray, Entry> mEntries; /**< the entries by their canonical history */
+    QMutex mMutex; /**< the solvers of different threads share the table */
+    quint32 mStamp; /**< the current time of the table */
+    int mCapacity; /**< the maximum number of entries */
+    bool mChanged; /**< is the table changed since it is loaded? */
+};
+
+#endif // TRANSPOSITIONTABLE_H
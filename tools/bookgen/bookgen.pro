@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# bookgen writes the opening book of the solver
+#
+#-------------------------------------------------
+
+QT	   += core
+QT	   -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+CONFIG += console
+CONFIG -= app_bundle
+
+MOC_DIR = build
+OBJECTS_DIR = build
+
+TEMPLATE = app
+TARGET = bookgen
+
+include(../../src/core.pri)
+
+SOURCES += main.cpp \
+	sharddriver.cpp
+
+HEADERS += sharddriver.h
+
+OTHER_FILES += \
+	bookgen.qbs
@@ -0,0 +1,280 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+/**
+ * bookgen writes the opening book of the solver, the first plies of the
+ * decision trees of every configuration, algorithm and engine.
+ *
+ * usage: bookgen [--plies N] [--colors C] [--pegs P] [--output FILE]
+ *                [--optimal [--worst-case] [--max-codes N]]
+ *        bookgen --optimal --colors C --pegs P [--distinct-colors] [--worst-case]
+ *                --shard-dir DIR [--workers N] [--output FILE]
+ *        bookgen --worker DIR
+ *
+ * With --optimal, the book also gets the optimal trees of the configurations
+ * of at most --max-codes codes (256 by default), for the Optimal algorithm.
+ *
+ * With --shard-dir, the optimal tree of one configuration is searched by
+ * --workers processes (one per core by default), and the book gets only this
+ * tree. The run resumes from the results in DIR when it is interrupted, and
+ * more workers, on other machines sharing DIR, join it with --worker DIR.
+ */
+
+#include "solver.h"
+#include "guess.h"
+#include "openingbook.h"
+#include "optimalstrategy.h"
+#include "sharddriver.h"
+#include <QCoreApplication>
+#include <QStringList>
+#include <QtConcurrentMap>
+#include <cstdio>
+
+/**
+ * @brief The Node struct
+ * A node of a decision tree, the game history that leads to it and its guess
+ */
+struct Node {
+    int colors;
+    int pegs;
+    bool sameColors;
+    Algorithm algorithm;
+    Engine engine;
+    QVector<unsigned char> guesses; /**< the played guesses, pegs colors for each guess */
+    QVector<int> responses; /**< the response index of each played guess */
+    unsigned char guess[MAX_SLOT_NUMBER]; /**< the guess of the solver */
+    bool valid; /**< is the history consistent? */
+    int parent; /**< the index of the parent node */
+    QVector<quint32> children; /**< the child index for each response */
+};
+
+/**
+ * @brief solve set the history of a node on a fresh solver and find its guess
+ * @param node the node
+ */
+static void solve(Node& node)
+{
+    Guess guess;
+    unsigned char code[MAX_SLOT_NUMBER] = {0, 0, 0, 0, 0};
+    guess.setCode(node.pegs, code);
+
+    Solver solver(&guess);
+    solver.setOpeningBook(0);
+    solver.setTranspositionTable(0);
+    guess.reset(node.algorithm, solver.reset(node.colors, node.pegs, node.sameColors));
+
+    if (node.responses.isEmpty()) {
+        node.valid = true;
+        solver.firstGuess(node.algorithm, node.guess);
+        return;
+    }
+
+    node.valid = solver.setHistory(node.guesses, node.responses);
+    if (!node.valid)
+        return;
+
+    solver.startGuessing(node.algorithm, node.engine);
+    solver.wait();
+    for(int i = 0; i < node.pegs; ++i)
+        node.guess[i] = guess.guess()[i];
+}
+
+/**
+ * @brief generate build the tree of a configuration, level by level
+ * @return OpeningBook::Section the tree
+ */
+static OpeningBook::Section generate(const int& colors, const int& pegs, const bool& same_colors,
+                                     const Algorithm& algorithm, const Engine& engine, const int& plies)
+{
+    const int responses = (pegs + 1)*(pegs + 2)/2;
+
+    QVector<Node> tree;
+    Node root;
+    root.colors = colors;
+    root.pegs = pegs;
+    root.sameColors = same_colors;
+    root.algorithm = algorithm;
+    root.engine = engine;
+    root.parent = -1;
+    solve(root);
+    root.children.fill(0, responses);
+    tree.append(root);
+
+    int level_begin = 0;
+    for(int ply = 1; ply < plies; ++ply) {
+        int level_end = tree.size();
+        QVector<Node> level;
+        for(int parent = level_begin; parent < level_end; ++parent) {
+            // the win and the impossible (p-1, 1) responses have no child
+            for(int response = 0; response < responses - 2; ++response) {
+                Node child = tree.at(parent);
+                for(int i = 0; i < pegs; ++i)
+                    child.guesses.append(child.guess[i]);
+                child.responses.append(response);
+                child.parent = parent;
+                level.append(child);
+            }
+        }
+
+        QtConcurrent::blockingMap(level, solve);
+
+        foreach(Node child, level) {
+            if (!child.valid)
+                continue;
+            tree[child.parent].children[child.responses.last()] = tree.size();
+            tree.append(child);
+        }
+        level_begin = level_end;
+    }
+
+    OpeningBook::Section section;
+    section.colors = colors;
+    section.pegs = pegs;
+    section.sameColors = same_colors ? 1 : 0;
+    section.algorithm = static_cast<quint8>(algorithm);
+    section.engine = static_cast<quint8>(engine);
+    section.plies = plies;
+    foreach(const Node& node, tree) {
+        quint32 key = 0;
+        for(int i = 0; i < pegs; ++i)
+            key = key*colors + node.guess[i];
+        section.nodes.append(key);
+        section.nodes += node.children;
+    }
+    return section;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VER);
+
+    int plies = 2;
+    int only_colors = 0;
+    int only_pegs = 0;
+    QString output = "qtmind.book";
+    bool optimal = false;
+    OptimalStrategy::Objective objective = OptimalStrategy::Objective::EXPECTED_GUESSES;
+    int max_codes = 256;
+    bool same_colors = true;
+    QString shard_dir;
+    int workers = QThread::idealThreadCount();
+
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size(); ++i) {
+        if (args.at(i) == "--plies" && i + 1 < args.size()) {
+            plies = args.at(++i).toInt();
+        } else if (args.at(i) == "--colors" && i + 1 < args.size()) {
+            only_colors = args.at(++i).toInt();
+        } else if (args.at(i) == "--pegs" && i + 1 < args.size()) {
+            only_pegs = args.at(++i).toInt();
+        } else if (args.at(i) == "--output" && i + 1 < args.size()) {
+            output = args.at(++i);
+        } else if (args.at(i) == "--optimal") {
+            optimal = true;
+        } else if (args.at(i) == "--worst-case") {
+            objective = OptimalStrategy::Objective::WORST_CASE;
+        } else if (args.at(i) == "--max-codes" && i + 1 < args.size()) {
+            max_codes = args.at(++i).toInt();
+        } else if (args.at(i) == "--distinct-colors") {
+            same_colors = false;
+        } else if (args.at(i) == "--shard-dir" && i + 1 < args.size()) {
+            shard_dir = args.at(++i);
+        } else if (args.at(i) == "--workers" && i + 1 < args.size()) {
+            workers = args.at(++i).toInt();
+        } else if (args.at(i) == "--worker" && i + 1 < args.size()) {
+            return ShardDriver(args.at(++i)).work() ? 0 : 1;
+        } else {
+            fprintf(stderr, "usage: bookgen [--plies N] [--colors C] [--pegs P] [--output FILE]\n"
+                            "               [--optimal [--worst-case] [--max-codes N]]\n"
+                            "       bookgen --optimal --colors C --pegs P [--distinct-colors] [--worst-case]\n"
+                            "               --shard-dir DIR [--workers N] [--output FILE]\n"
+                            "       bookgen --worker DIR\n");
+            return 1;
+        }
+    }
+
+    if (!shard_dir.isEmpty()) {
+        if (!optimal || !only_colors || !only_pegs || workers < 1) {
+            fprintf(stderr, "bookgen: --shard-dir needs --optimal, --colors, --pegs and at least one worker\n");
+            return 1;
+        }
+        ShardDriver driver(shard_dir);
+        if (!driver.prepare(only_colors, only_pegs, same_colors, objective) || !driver.runWorkers(workers))
+            return 1;
+        OpeningBook::Section section;
+        int cost;
+        if (!driver.merge(&section, &cost))
+            return 1;
+        fprintf(stderr, "colors %d, pegs %d, same colors %d, optimal: cost %d, %d plies\n",
+                only_colors, only_pegs, same_colors ? 1 : 0, cost, section.plies);
+        if (!OpeningBook::save(output, QList<OpeningBook::Section>() << section)) {
+            fprintf(stderr, "bookgen: could not write %s\n", qPrintable(output));
+            return 1;
+        }
+        return 0;
+    }
+    if (plies < 1) {
+        fprintf(stderr, "bookgen: the number of plies must be positive\n");
+        return 1;
+    }
+    // the workers of a level share the speed, measured before they load the machine
+    Solver::measureDefaultSpeed();
+
+    QList<Algorithm> algorithms;
+    algorithms << Algorithm::MOST_PARTS << Algorithm::WORST_CASE << Algorithm::EXPECTED_SIZE << Algorithm::ENTROPY;
+    QList<Engine> engines;
+    engines << Engine::ONE_STEP << Engine::LOOKAHEAD;
+
+    QList<OpeningBook::Section> sections;
+    for(int colors = MIN_COLOR_NUMBER; colors <= MAX_COLOR_NUMBER; ++colors) {
+        if (only_colors && colors != only_colors)
+            continue;
+        for(int pegs = MIN_SLOT_NUMBER; pegs <= MAX_SLOT_NUMBER; ++pegs) {
+            if (only_pegs && pegs != only_pegs)
+                continue;
+            for(int same = 1; same >= 0; --same) {
+                if (!same && pegs > colors)
+                    continue;
+                if (optimal && CodeTables::acquire(colors, pegs, same)->size() <= max_codes) {
+                    OptimalStrategy strategy(colors, pegs, same, objective);
+                    int cost = strategy.solve();
+                    sections.append(strategy.section());
+                    fprintf(stderr, "colors %d, pegs %d, same colors %d, optimal: cost %d, %d plies\n",
+                            colors, pegs, same, cost, sections.last().plies);
+                }
+                foreach(Algorithm algorithm, algorithms) {
+                    foreach(Engine engine, engines) {
+                        sections.append(generate(colors, pegs, same, algorithm, engine, plies));
+                        fprintf(stderr, "colors %d, pegs %d, same colors %d, algorithm %d, engine %d: %d nodes\n",
+                                colors, pegs, same, static_cast<int>(algorithm), static_cast<int>(engine),
+                                sections.last().nodes.size()/(1 + (pegs + 1)*(pegs + 2)/2));
+                    }
+                }
+            }
+        }
+    }
+
+    if (!OpeningBook::save(output, sections)) {
+        fprintf(stderr, "bookgen: could not write %s\n", qPrintable(output));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,321 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+
+#include "sharddriver.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QLockFile>
+#include <QProcess>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+
+static const quint32 MAGIC = 0x514d5352; /**< "QMSR", the magic number of a result file */
+static const quint16 VERSION = 1; /**< the version of the result file */
+
+ShardDriver::ShardDriver(const QString& directory):
+    mDirectory(directory),
+    mColors(0),
+    mPegs(0),
+    mSameColors(true),
+    mObjective(OptimalStrategy::Objective::EXPECTED_GUESSES)
+{
+}
+
+bool ShardDriver::prepare(const int& colors, const int& pegs, const bool& same_colors,
+                          const OptimalStrategy::Objective& objective)
+{
+    if (QFile::exists(mDirectory + "/units.txt")) {
+        // resume, the results of the interrupted run are kept
+        if (!readUnits())
+            return false;
+        if (mColors != colors || mPegs != pegs || mSameColors != same_colors || mObjective != objective) {
+            fprintf(stderr, "bookgen: %s holds the units of another search\n", qPrintable(mDirectory));
+            return false;
+        }
+        return true;
+    }
+
+    mColors = colors;
+    mPegs = pegs;
+    mSameColors = same_colors;
+    mObjective = objective;
+    mUnits.clear();
+
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(colors, pegs, same_colors);
+    const int max_response = (pegs + 1)*(pegs + 2)/2;
+    OptimalStrategy strategy(colors, pegs, same_colors, objective);
+    foreach(int guess, strategy.firstGuesses()) {
+        QVector<int> part_sizes(max_response, 0);
+        for(int code = 0; code < tables->size(); ++code)
+            ++part_sizes[tables->response(guess, code)];
+        // the win has no part to search
+        for(int response = 0; response < max_response - 1; ++response) {
+            if (part_sizes.at(response) == 0)
+                continue;
+            Unit unit;
+            unit.guess = guess;
+            unit.response = response;
+            unit.size = part_sizes.at(response);
+            mUnits.append(unit);
+        }
+    }
+    // the largest units first, so that the workers end at about the same time
+    std::stable_sort(mUnits.begin(), mUnits.end(), [](const Unit& a, const Unit& b) {
+        return a.size > b.size;
+    });
+
+    QDir().mkpath(mDirectory);
+    QFile file(mDirectory + "/units.txt.tmp");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out << mColors << ' ' << mPegs << ' ' << (mSameColors ? 1 : 0) << ' '
+        << (mObjective == OptimalStrategy::Objective::WORST_CASE ? 1 : 0) << '\n';
+    foreach(const Unit& unit, mUnits)
+        out << unit.guess << ' ' << unit.response << ' ' << unit.size << '\n';
+    out.flush();
+    file.close();
+    if (file.error() != QFile::NoError)
+        return false;
+    // another driver may have written the same units meanwhile
+    if (!file.rename(mDirectory + "/units.txt")) {
+        file.remove();
+        return readUnits();
+    }
+    return true;
+}
+
+bool ShardDriver::runWorkers(const int& workers)
+{
+    QList<QProcess*> processes;
+    for(int i = 0; i < workers; ++i) {
+        QProcess* process = new QProcess;
+        process->setProcessChannelMode(QProcess::ForwardedChannels);
+        process->start(QCoreApplication::applicationFilePath(), QStringList() << "--worker" << mDirectory);
+        processes.append(process);
+    }
+
+    bool ok = true;
+    foreach(QProcess* process, processes) {
+        if (!process->waitForStarted(-1) || !process->waitForFinished(-1) ||
+                process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0)
+            ok = false;
+        delete process;
+    }
+    return ok;
+}
+
+bool ShardDriver::work()
+{
+    if (!readUnits())
+        return false;
+
+    // one strategy for all the units, so that their common subproblems are searched once
+    OptimalStrategy strategy(mColors, mPegs, mSameColors, mObjective);
+    bool ok = true;
+    for(int i = 0; i < mUnits.size(); ++i) {
+        if (QFile::exists(fileName(i, "result")))
+            continue;
+        // a lock whose process is dead is taken over, on the same host
+        QLockFile lock(fileName(i, "lock"));
+        lock.setStaleLockTime(0);
+        if (!lock.tryLock(0))
+            continue;
+        if (QFile::exists(fileName(i, "result")))
+            continue;
+
+        const QVector<int> unit_possibles = possibles(mUnits.at(i));
+        int cost = strategy.solve(unit_possibles, false);
+        int depth;
+        QVector<quint32> nodes = strategy.tree(unit_possibles, &depth);
+        if (!writeResult(i, cost, depth, nodes)) {
+            fprintf(stderr, "bookgen: could not write %s\n", qPrintable(fileName(i, "result")));
+            ok = false;
+            continue;
+        }
+        fprintf(stderr, "unit %d of %d, %d codes: cost %d\n", i + 1, mUnits.size(), mUnits.at(i).size, cost);
+    }
+    return ok;
+}
+
+bool ShardDriver::merge(OpeningBook::Section* section, int* cost)
+{
+    if (mUnits.isEmpty() && !readUnits())
+        return false;
+
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(mColors, mPegs, mSameColors);
+    const int max_response = (mPegs + 1)*(mPegs + 2)/2;
+    OptimalStrategy strategy(mColors, mPegs, mSameColors, mObjective);
+
+    // the units of each first guess, in the order of the guesses
+    QVector<int> guesses;
+    QHash<int, QList<int> > guess_units;
+    for(int i = 0; i < mUnits.size(); ++i) {
+        if (!guess_units.contains(mUnits.at(i).guess))
+            guesses.append(mUnits.at(i).guess);
+        guess_units[mUnits.at(i).guess].append(i);
+    }
+    std::sort(guesses.begin(), guesses.end());
+
+    int pending = 0;
+    int best = -1;
+    int best_cost = 0;
+    foreach(int guess, guesses) {
+        QVector<int> part_costs;
+        foreach(int unit, guess_units.value(guess)) {
+            int part_cost, depth;
+            QVector<quint32> nodes;
+            if (!readResult(unit, &part_cost, &depth, &nodes)) {
+                ++pending;
+                continue;
+            }
+            part_costs.append(part_cost);
+        }
+        if (part_costs.size() != guess_units.value(guess).size())
+            continue;
+        int guess_cost = strategy.combine(tables->size(), part_costs);
+        if (best < 0 || guess_cost < best_cost) {
+            best = guess;
+            best_cost = guess_cost;
+        }
+    }
+    if (pending > 0) {
+        fprintf(stderr, "bookgen: %d of %d units have no result yet\n", pending, mUnits.size());
+        return false;
+    }
+
+    section->colors = mColors;
+    section->pegs = mPegs;
+    section->sameColors = mSameColors ? 1 : 0;
+    section->algorithm = static_cast<quint8>(Algorithm::OPTIMAL);
+    section->engine = static_cast<quint8>(Engine::ONE_STEP);
+    section->plies = 1;
+    section->nodes.clear();
+
+    quint32 key = 0;
+    const unsigned char* code = tables->code(best);
+    for(int i = 0; i < mPegs; ++i)
+        key = key*mColors + code[i];
+    section->nodes.append(key);
+    section->nodes += QVector<quint32>(max_response, 0);
+
+    // the trees of the parts follow the root, their child indices shifted by their offset
+    QList<int> units = guess_units.value(best);
+    std::sort(units.begin(), units.end(), [this](const int& a, const int& b) {
+        return mUnits.at(a).response < mUnits.at(b).response;
+    });
+    foreach(int unit, units) {
+        int part_cost, depth;
+        QVector<quint32> nodes;
+        readResult(unit, &part_cost, &depth, &nodes);
+        const quint32 offset = section->nodes.size()/(1 + max_response);
+        section->nodes[1 + mUnits.at(unit).response] = offset;
+        for(int i = 0; i < nodes.size(); ++i) {
+            if (i % (1 + max_response) != 0 && nodes.at(i) != 0)
+                nodes[i] += offset;
+        }
+        section->nodes += nodes;
+        section->plies = qMax((int) section->plies, 1 + depth);
+    }
+    *cost = best_cost;
+    return true;
+}
+
+bool ShardDriver::readUnits()
+{
+    QFile file(mDirectory + "/units.txt");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        fprintf(stderr, "bookgen: could not read %s\n", qPrintable(file.fileName()));
+        return false;
+    }
+    QTextStream in(&file);
+    int same_colors, worst_case;
+    in >> mColors >> mPegs >> same_colors >> worst_case;
+    mSameColors = (same_colors != 0);
+    mObjective = worst_case ? OptimalStrategy::Objective::WORST_CASE : OptimalStrategy::Objective::EXPECTED_GUESSES;
+    if (in.status() != QTextStream::Ok || mColors < MIN_COLOR_NUMBER || mColors > MAX_COLOR_NUMBER ||
+            mPegs < MIN_SLOT_NUMBER || mPegs > MAX_SLOT_NUMBER) {
+        fprintf(stderr, "bookgen: %s is not a list of units\n", qPrintable(file.fileName()));
+        return false;
+    }
+
+    mUnits.clear();
+    forever {
+        Unit unit;
+        in >> unit.guess >> unit.response >> unit.size;
+        if (in.status() != QTextStream::Ok)
+            break;
+        mUnits.append(unit);
+    }
+    return !mUnits.isEmpty();
+}
+
+QVector<int> ShardDriver::possibles(const Unit& unit) const
+{
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(mColors, mPegs, mSameColors);
+    QVector<int> unit_possibles;
+    unit_possibles.reserve(unit.size);
+    for(int code = 0; code < tables->size(); ++code) {
+        if (tables->response(unit.guess, code) == unit.response)
+            unit_possibles.append(code);
+    }
+    return unit_possibles;
+}
+
+bool ShardDriver::readResult(const int& unit, int* cost, int* depth, QVector<quint32>* nodes) const
+{
+    QFile file(fileName(unit, "result"));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    qint32 result_cost, result_depth;
+    in >> magic >> version >> result_cost >> result_depth >> *nodes;
+    if (in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION)
+        return false;
+    *cost = result_cost;
+    *depth = result_depth;
+    return true;
+}
+
+bool ShardDriver::writeResult(const int& unit, const int& cost, const int& depth, const QVector<quint32>& nodes) const
+{
+    // written aside and renamed, so that an interrupted worker leaves no partial result
+    QFile file(fileName(unit, "result.tmp"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QDataStream out(&file);
+    out << MAGIC << VERSION << (qint32) cost << (qint32) depth << nodes;
+    file.close();
+    if (out.status() != QDataStream::Ok || file.error() != QFile::NoError)
+        return false;
+    return file.rename(fileName(unit, "result"));
+}
+
+QString ShardDriver::fileName(const int& unit, const QString& suffix) const
+{
+    return QString("%1/%2.%3").arg(mDirectory).arg(unit).arg(suffix);
+}
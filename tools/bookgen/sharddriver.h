@@ -0,0 +1,124 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+
+#ifndef SHARDDRIVER_H
+#define SHARDDRIVER_H
+
+#include <QString>
+#include <QVector>
+#include "optimalstrategy.h"
+
+/**    @brief The class ShardDriver runs the optimal search of a large configuration
+ *    as independent work units, so that it can be interrupted, resumed and spread
+ *    over several processes, or several machines that share the directory.
+ *
+ *    A work unit is one part of one first guess, the codes that give one response
+ *    to it. The directory holds:
+ *
+ *    units.txt:      the configuration and the objective on the first line,
+ *                    followed by the first guess, the response and the size of
+ *                    each unit, the largest units first
+ *
+ *    N.lock:         the lock of the worker that searches the unit N
+ *
+ *    N.result:       the cost, the depth and the tree of the unit N, the
+ *                    checkpoint of the run
+ *
+ *    The results are merged by the first guesses in the order of their codes,
+ *    so the merged tree does not depend on the number of workers or the order
+ *    in which they finish.
+ */
+class ShardDriver
+{
+public:
+    /**
+     * @brief ShardDriver
+     * @param directory the directory of the units and their results
+     */
+    explicit ShardDriver(const QString& directory);
+
+    /**
+     * @brief prepare write the units of a configuration, or check the ones of
+     * an interrupted run
+     * @return true if the directory holds the units of the configuration
+     */
+    bool prepare(const int& colors, const int& pegs, const bool& same_colors,
+                 const OptimalStrategy::Objective& objective);
+
+    /**
+     * @brief runWorkers run worker processes until every unit has its result
+     * @param workers the number of processes
+     * @return true if all the workers finished normally
+     */
+    bool runWorkers(const int& workers);
+
+    /**
+     * @brief work search the units that have no result and are not locked by
+     * another worker, one after another
+     * @return true if the units are read and no result failed to be written
+     */
+    bool work();
+
+    /**
+     * @brief merge find the best first guess from the results of the units
+     * @param section the optimal tree, in the format of the opening book
+     * @param cost the cost of the optimal tree
+     * @return true if every unit has its result
+     */
+    bool merge(OpeningBook::Section* section, int* cost);
+
+private:
+    /**
+    * @brief The Unit struct
+    * A part of a first guess
+    */
+    struct Unit {
+        int guess; /**< the code index of the first guess */
+        int response; /**< the response of the part */
+        int size; /**< the number of codes in the part */
+    };
+
+    /**
+     * @brief readUnits read the configuration and the units
+     * @return true if the units are read
+     */
+    bool readUnits();
+
+    /**
+     * @brief possibles the codes of a unit
+     * @return QVector<int> the sorted code indices
+     */
+    QVector<int> possibles(const Unit& unit) const;
+
+    bool readResult(const int& unit, int* cost, int* depth, QVector<quint32>* nodes) const;
+    bool writeResult(const int& unit, const int& cost, const int& depth, const QVector<quint32>& nodes) const;
+
+    QString fileName(const int& unit, const QString& suffix) const;
+
+private:
+    QString mDirectory; /**< the directory of the run */
+    int mColors; /**< the number of colors */
+    int mPegs; /**< the number of pegs */
+    bool mSameColors; /**< same color allowed flag */
+    OptimalStrategy::Objective mObjective; /**< the objective of the search */
+    QVector<Unit> mUnits; /**< the work units */
+};
+
+#endif // SHARDDRIVER_H
@@ -0,0 +1,32 @@
+#-------------------------------------------------
+#
+# guibench times the painting of the board in scripted games, and soaks
+# the game in thousands of them
+#
+#-------------------------------------------------
+
+QT	   += core gui widgets testlib
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+CONFIG += console
+CONFIG -= app_bundle
+
+MOC_DIR = build
+OBJECTS_DIR = build
+
+TEMPLATE = app
+TARGET = guibench
+
+include(../../src/core.pri)
+include(../../src/board.pri)
+
+SOURCES += main.cpp \
+	guibenchmark.cpp \
+	memoryusage.cpp
+
+HEADERS += guibenchmark.h \
+	memoryusage.h
+
+OTHER_FILES += \
+	guibench.qbs
@@ -0,0 +1,354 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "guibenchmark.h"
+#include "memoryusage.h"
+#include "button.h"
+#include "pegbox.h"
+#include "pinbox.h"
+#include "tracer.h"
+#include "transpositiontable.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMouseEvent>
+#include <QStringList>
+#include <QTest>
+#include <QtCore/qmath.h>
+#include <algorithm>
+
+static const int DRAG_STEPS = 4; /**< The mouse moves of a peg drag */
+static const int GUESS_TIMEOUT = 60000; /**< The longest wait for a guess of the solver in milliseconds */
+static const int RESIZE_REPEATS = 5; /**< The times that each size is set */
+static const int SOAK_TABLE_CAPACITY = 1000; /**< The capacity of the transposition table in the soak */
+
+/**
+* @brief The Configuration struct
+* A configuration and a mode of a game
+*/
+struct Configuration {
+    int colors;
+    int pegs;
+    bool sameColors;
+    Mode mode;
+    Algorithm algorithm;
+};
+
+static const Configuration CONFIGURATIONS[] = {
+    {6, 4, true, Mode::MVH, Algorithm::MOST_PARTS},
+    {6, 4, true, Mode::HVM, Algorithm::MOST_PARTS},
+    {8, 5, true, Mode::MVH, Algorithm::EXPECTED_SIZE},
+    {10, 4, false, Mode::HVM, Algorithm::EXPECTED_SIZE},
+    {5, 3, false, Mode::MVH, Algorithm::WORST_CASE},
+    {9, 5, false, Mode::HVM, Algorithm::WORST_CASE}
+};
+static const int CONFIGURATIONS_SIZE = sizeof(CONFIGURATIONS)/sizeof(Configuration);
+
+/** The sizes of the view that the resize goes through, the first is the size of the games */
+static const QSize SIZES[] = {
+    QSize(360, 630), QSize(480, 840), QSize(720, 1260), QSize(640, 480), QSize(320, 560)
+};
+static const int SIZES_SIZE = sizeof(SIZES)/sizeof(QSize);
+
+GuiBenchmark::GuiBenchmark(const int& games, const QString& trace_file):
+    mGames(games),
+    mTraceFile(trace_file),
+    mMoves(0)
+{
+    mGame.setTools(&mTools);
+    // the pins are put and the rows are closed by the script
+    mTools.mAutoPutPins = true;
+    mTools.mAutoCloseRows = false;
+}
+
+bool GuiBenchmark::run()
+{
+    if (!showBoard())
+        return false;
+
+    Tracer::start(mTraceFile);
+    Tracer::setThreadName("GUI");
+    bool finished = true;
+    for(int i = 0; i < mGames && finished; ++i)
+        finished = playGame(i);
+    measureResize();
+    mGame.stop();
+    frame();
+
+    if (!Tracer::stop() || !readTrace())
+        return false;
+    mResults.append(summary("resize", mResizes));
+    return finished;
+}
+
+bool GuiBenchmark::soak()
+{
+    if (!showBoard())
+        return false;
+    // the table is full within the warm-up, so that its bound is soaked too
+    TranspositionTable::instance()->setCapacity(SOAK_TABLE_CAPACITY);
+
+    bool finished = true;
+    for(int i = 0; i < mGames && finished; ++i) {
+        finished = playGame(i);
+        if ((i + 1) % CONFIGURATIONS_SIZE == 0 || i + 1 == mGames) {
+            mGame.stop();
+            frame();
+            Sample sample;
+            sample.games = i + 1;
+            sample.residentSize = MemoryUsage::residentSize();
+            sample.heapSize = MemoryUsage::heapSize();
+            mSamples.append(sample);
+        }
+    }
+    return finished;
+}
+
+qreal GuiBenchmark::residentGrowth() const
+{
+    QVector<qreal> values;
+    foreach(const Sample& sample, mSamples) {
+        if (sample.residentSize < 0)
+            return 0;
+        values.append(sample.residentSize);
+    }
+    return growth(values);
+}
+
+qreal GuiBenchmark::heapGrowth() const
+{
+    QVector<qreal> values;
+    foreach(const Sample& sample, mSamples) {
+        if (sample.heapSize < 0)
+            return 0;
+        values.append(sample.heapSize);
+    }
+    return growth(values);
+}
+
+bool GuiBenchmark::showBoard()
+{
+    qsrand(1);
+    mGame.resize(SIZES[0]);
+    mGame.show();
+    return QTest::qWaitForWindowExposed(&mGame);
+}
+
+bool GuiBenchmark::playGame(const int& index)
+{
+    const Configuration& configuration = CONFIGURATIONS[index % CONFIGURATIONS_SIZE];
+    mGame.setColors(configuration.colors);
+    mGame.setPegs(configuration.pegs);
+    mGame.setSameColors(configuration.sameColors);
+    mGame.setMode(configuration.mode);
+    mGame.setAlgorithm(configuration.algorithm);
+    mGame.setEngine(Engine::AUTO);
+    mGame.play();
+    frame();
+    return (configuration.mode == Mode::MVH) ? playMVH() : playHVM();
+}
+
+bool GuiBenchmark::playMVH()
+{
+    unsigned char code[MAX_SLOT_NUMBER];
+    randomCode(code);
+    for(int i = 0; i < mGame.pegs(); ++i)
+        dragPeg(code[i], mGame.mMasterBoxes.at(i));
+    if (mGame.mState != Game::State::WaittingDoneButtonPress)
+        return false;
+    click(mGame.mDoneButton);
+
+    while (waitWhileThinking() && mGame.mState == Game::State::WaittingOkButtonPress) {
+        ++mMoves;
+        click(mGame.mOkButton);
+        // a refused response is not put again
+        if (mGame.mState == Game::State::WaittingOkButtonPress)
+            return false;
+    }
+    return mGame.mState == Game::State::Win || mGame.mState == Game::State::Lose;
+}
+
+bool GuiBenchmark::playHVM()
+{
+    while (mGame.mState == Game::State::WaittingFirstRowFill || mGame.mState == Game::State::WaittingCodeRowFill) {
+        unsigned char code[MAX_SLOT_NUMBER];
+        randomCode(code);
+        for(int i = 0; i < mGame.pegs(); ++i)
+            dragPeg(code[i], mGame.mCurrentBoxes.at(i));
+        if (mGame.mState != Game::State::WaittingPinboxPress)
+            return false;
+        ++mMoves;
+        click(mGame.mOkButton);
+    }
+    return mGame.mState == Game::State::Win || mGame.mState == Game::State::Lose;
+}
+
+void GuiBenchmark::randomCode(unsigned char* code) const
+{
+    int remaining_colors = mGame.colors();
+    for(int i = 0; i < mGame.pegs(); ++i) {
+        code[i] = static_cast<unsigned char>(remaining_colors*(qrand()/(RAND_MAX + 1.0)));
+        if (!mGame.isSameColors()) {
+            // the colors before are skipped, from the smallest up
+            unsigned char sorted[MAX_SLOT_NUMBER];
+            std::copy(code, code + i, sorted);
+            std::sort(sorted, sorted + i);
+            for(int j = 0; j < i; ++j)
+                if (sorted[j] <= code[i])
+                    ++code[i];
+            --remaining_colors;
+        }
+    }
+}
+
+void GuiBenchmark::dragPeg(const int& color, PegBox* box)
+{
+    QWidget* viewport = mGame.viewport();
+    const QPoint from = mGame.mapFromScene(mGame.mPegBoxes.at(color)->sceneBoundingRect().center());
+    const QPoint to = mGame.mapFromScene(box->sceneBoundingRect().center());
+
+    QTest::mousePress(viewport, Qt::LeftButton, Qt::NoModifier, from);
+    frame();
+    // QTest::mouseMove sends no pressed button, which moves no peg
+    for(int i = 1; i <= DRAG_STEPS; ++i) {
+        QMouseEvent move(QEvent::MouseMove, from + (to - from)*i/DRAG_STEPS,
+                         Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+        QApplication::sendEvent(viewport, &move);
+        frame();
+    }
+    QTest::mouseRelease(viewport, Qt::LeftButton, Qt::NoModifier, to);
+    frame();
+}
+
+void GuiBenchmark::click(Button* button)
+{
+    QTest::mouseClick(mGame.viewport(), Qt::LeftButton, Qt::NoModifier,
+                      mGame.mapFromScene(button->sceneBoundingRect().center()));
+    frame();
+}
+
+void GuiBenchmark::frame()
+{
+    // the scene posts its changes to the view, and the view its update to the window
+    QCoreApplication::sendPostedEvents();
+    QCoreApplication::processEvents();
+}
+
+bool GuiBenchmark::waitWhileThinking()
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (mGame.mState == Game::State::Thinking) {
+        if (timer.elapsed() > GUESS_TIMEOUT)
+            return false;
+        QTest::qWait(1);
+    }
+    frame();
+    return true;
+}
+
+void GuiBenchmark::measureResize()
+{
+    QElapsedTimer timer;
+    for(int r = 0; r < RESIZE_REPEATS; ++r) {
+        for(int i = 1; i <= SIZES_SIZE; ++i) {
+            timer.start();
+            mGame.resize(SIZES[i % SIZES_SIZE]);
+            frame();
+            mResizes.append(timer.nsecsElapsed()/1000);
+        }
+    }
+}
+
+bool GuiBenchmark::readTrace()
+{
+    QFile file(mTraceFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll()).object().value("traceEvents").toArray();
+
+    // the phases of the solver are left to solverbench
+    QHash<QString, QVector<qint64> > durations;
+    QStringList names;
+    for(int i = 0; i < events.size(); ++i) {
+        const QJsonObject event = events.at(i).toObject();
+        const QString category = event.value("cat").toString();
+        if (event.value("ph").toString() != "X" || (category != "game" && category != "paint"))
+            continue;
+        const QString name = event.value("name").toString();
+        if (!durations.contains(name))
+            names.append(name);
+        durations[name].append((qint64) event.value("dur").toDouble());
+    }
+    foreach(const QString& name, names)
+        mResults.append(summary(name, durations.value(name)));
+    return !events.isEmpty();
+}
+
+GuiBenchmark::Result GuiBenchmark::summary(const QString& name, QVector<qint64> durations)
+{
+    Result result;
+    result.name = name;
+    result.count = durations.size();
+    result.mean = result.p50 = result.p99 = result.max = result.total = 0;
+    if (durations.isEmpty())
+        return result;
+
+    std::sort(durations.begin(), durations.end());
+    qint64 total = 0;
+    foreach(qint64 duration, durations)
+        total += duration;
+    // the nearest rank percentiles
+    const int size = durations.size();
+    result.mean = (qreal) total/size;
+    result.p50 = durations.at(qMax(0, qCeil(0.50*size) - 1));
+    result.p99 = durations.at(qMax(0, qCeil(0.99*size) - 1));
+    result.max = durations.last();
+    result.total = total/1000.0;
+    return result;
+}
+
+qreal GuiBenchmark::growth(const QVector<qreal>& values) const
+{
+    const int begin = values.size()/4;
+    const int size = values.size() - begin;
+    if (size < 2)
+        return 0;
+
+    qreal mean_x = 0;
+    qreal mean_y = 0;
+    for(int i = begin; i < values.size(); ++i) {
+        mean_x += mSamples.at(i).games;
+        mean_y += values.at(i);
+    }
+    mean_x /= size;
+    mean_y /= size;
+    qreal covariance = 0;
+    qreal variance = 0;
+    for(int i = begin; i < values.size(); ++i) {
+        const qreal dx = mSamples.at(i).games - mean_x;
+        covariance += dx*(values.at(i) - mean_y);
+        variance += dx*dx;
+    }
+    return variance > 0 ? 1000*covariance/variance : 0;
+}
@@ -0,0 +1,183 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef GUIBENCHMARK_H
+#define GUIBENCHMARK_H
+
+#include "game.h"
+#include "tools.h"
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**    @brief The class GuiBenchmark plays scripted games on the board as a player
+ *    would, dragging the pegs and pressing the buttons with QTest, and times the
+ *    painting of the board. The configurations and the modes alternate from a
+ *    game to the next: the solver breaks the hidden code of every other game,
+ *    and random codes are tried in the others, which mostly fill the board.
+ *
+ *    The paint of the view, of the background, of each peg, box and message,
+ *    the message updates and the initialization of the scene are traced by the
+ *    Tracer, and summarized from its trace file. The resize of the view is timed
+ *    directly, with the paint that it causes.
+ *
+ *    The soak plays the games untraced, and samples the memory of the process
+ *    after every round of the configurations, on the same empty board. The
+ *    growth of a sample to the next is the slope of the least squares line of
+ *    the samples after the warm-up, the first quarter, in which the caches are
+ *    filled.
+ */
+class GuiBenchmark
+{
+public:
+
+    /**
+    * @brief The Result struct
+    * The time of a traced phase
+    */
+    struct Result {
+        QString name; /**< the phase, such as Peg::paint or resize */
+        int count; /**< the number of times it is run */
+        qreal mean; /**< the mean time in microseconds */
+        qreal p50; /**< the median time in microseconds */
+        qreal p99; /**< the 99th percentile in microseconds */
+        qreal max; /**< the longest time in microseconds */
+        qreal total; /**< the total time in milliseconds */
+    };
+
+    /**
+    * @brief The Sample struct
+    * The memory of the process after some games
+    */
+    struct Sample {
+        int games; /**< the games played before the sample */
+        qint64 residentSize; /**< in kilobytes, -1 if not known */
+        qint64 heapSize; /**< in kilobytes, -1 if not known */
+    };
+
+    /**
+     * @brief GuiBenchmark
+     * @param games the number of games to be played
+     * @param trace_file the trace file of the run
+     */
+    GuiBenchmark(const int& games, const QString& trace_file);
+
+    /**
+     * @brief run play the games and time the resizes
+     * @return true if every game is finished, false if one gets stuck
+     */
+    bool run();
+    /**
+     * @brief soak play the games untraced and sample the memory of the process
+     * @return true if every game is finished, false if one gets stuck
+     */
+    bool soak();
+
+    QList<Result> results() const {return mResults;}
+    QList<Sample> samples() const {return mSamples;}
+    /**
+     * @brief residentGrowth the growth of the resident size in the soak
+     * @return qreal the kilobytes per thousand games
+     */
+    qreal residentGrowth() const;
+    /**
+     * @brief heapGrowth the growth of the heap in use in the soak
+     * @return qreal the kilobytes per thousand games
+     */
+    qreal heapGrowth() const;
+    int games() const {return mGames;}
+    /**
+     * @brief moves the number of rows played in all the games
+     */
+    int moves() const {return mMoves;}
+
+private:
+    /**
+     * @brief showBoard show the view and wait for it to be painted
+     * @return true if the view is shown
+     */
+    bool showBoard();
+    /**
+     * @brief playGame play a game of the alternating configurations
+     * @param index the index of the game
+     * @return true if the game is finished
+     */
+    bool playGame(const int& index);
+    /**
+     * @brief playMVH put a hidden code and answer the guesses of the solver
+     * @return true if the game is finished
+     */
+    bool playMVH();
+    /**
+     * @brief playHVM fill the rows with random codes until the code is broken
+     * or the board is full
+     * @return true if the game is finished
+     */
+    bool playHVM();
+    /**
+     * @brief randomCode a code of the current configuration
+     * @param code the pegs colors
+     */
+    void randomCode(unsigned char* code) const;
+    /**
+     * @brief dragPeg drag a peg from the color boxes and drop it on a box
+     * @param color the color of the peg
+     * @param box the box to drop on
+     */
+    void dragPeg(const int& color, PegBox* box);
+    /**
+     * @brief click press and release a button
+     */
+    void click(Button* button);
+    /**
+     * @brief frame deliver the updates of the scene, which paints the changed
+     * parts of the view
+     */
+    void frame();
+    /**
+     * @brief waitWhileThinking wait for the guess of the solver
+     * @return true if the guess is shown in time
+     */
+    bool waitWhileThinking();
+    void measureResize();
+    /**
+     * @brief readTrace summarize the phases of the board from the trace file
+     * @return true if the trace file is read
+     */
+    bool readTrace();
+    static Result summary(const QString& name, QVector<qint64> durations);
+    /**
+     * @brief growth the slope of a value of the samples after the warm-up
+     * @param values a value of each sample
+     * @return qreal the growth per thousand games
+     */
+    qreal growth(const QVector<qreal>& values) const;
+
+private:
+    int mGames;
+    QString mTraceFile;
+    int mMoves;
+    QVector<qint64> mResizes; /**< the time of each resize in microseconds */
+    QList<Result> mResults;
+    QList<Sample> mSamples;
+    Tools mTools;
+    Game mGame;
+};
+
+#endif // GUIBENCHMARK_H
@@ -0,0 +1,165 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+/**
+ * guibench plays scripted games on the board under the offscreen platform, and
+ * times the painting of the board.
+ *
+ * usage: guibench [--games N] [--output FILE] [--trace FILE]
+ *        guibench --soak [--games N] [--output FILE] [--max-growth KB]
+ *
+ * The pegs are dragged and the buttons pressed with QTest, in alternating
+ * configurations and modes, and the view is then resized through some sizes.
+ * The JSON output has the count, the mean, the median, the 99th percentile and
+ * the longest time in microseconds of each phase: the paint of the view, of
+ * its background and of each peg, box and message, the message updates, the
+ * initialization of the scene and the resize. With --trace, the Chrome trace
+ * of the run is kept.
+ *
+ * With --soak, 3000 games are played by default, untraced, and the resident
+ * size and the heap in use of the process are sampled after every round of
+ * the configurations. The heap is read from malloc, on glibc only. The JSON
+ * output has the samples and their growth per thousand games after the
+ * warm-up. guibench then fails if the resident size or the heap grows more
+ * than --max-growth kilobytes (1024 by default) per thousand games.
+ *
+ * It runs without a display, unless QT_QPA_PLATFORM names another platform.
+ * Its settings, records and tables are its own, apart from those of the game.
+ */
+
+#include "guibenchmark.h"
+#include "appinfo.h"
+#include <QApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    app.setApplicationName("guibench");
+    app.setApplicationVersion(APP_VER);
+    app.setOrganizationName(ORG_NAME);
+    app.setOrganizationDomain(ORG_DOMAIN);
+
+    int games = -1;
+    QString output;
+    QString trace;
+    bool soak = false;
+    qreal max_growth = 1024;
+
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size(); ++i) {
+        if (args.at(i) == "--games" && i + 1 < args.size()) {
+            games = args.at(++i).toInt();
+        } else if (args.at(i) == "--output" && i + 1 < args.size()) {
+            output = args.at(++i);
+        } else if (args.at(i) == "--trace" && i + 1 < args.size()) {
+            trace = args.at(++i);
+        } else if (args.at(i) == "--soak") {
+            soak = true;
+        } else if (args.at(i) == "--max-growth" && i + 1 < args.size()) {
+            max_growth = args.at(++i).toDouble();
+        } else {
+            games = 0;
+            break;
+        }
+    }
+    if (games == -1)
+        games = soak ? 3000 : 12;
+    if (games < 1 || (soak && !trace.isEmpty())) {
+        fprintf(stderr, "usage: guibench [--games N] [--output FILE] [--trace FILE]\n"
+                        "       guibench --soak [--games N] [--output FILE] [--max-growth KB]\n");
+        return 1;
+    }
+
+    // the phases are read back from the trace, which is then removed if not asked for
+    QTemporaryFile trace_file;
+    if (trace.isEmpty() && !soak) {
+        if (!trace_file.open()) {
+            fprintf(stderr, "guibench: could not create a trace file\n");
+            return 1;
+        }
+        trace = trace_file.fileName();
+        trace_file.close();
+    }
+
+    GuiBenchmark benchmark(games, trace);
+    const bool finished = soak ? benchmark.soak() : benchmark.run();
+    if (!finished)
+        fprintf(stderr, "guibench: a game did not finish\n");
+
+    QJsonObject report;
+    report.insert("platform", QGuiApplication::platformName());
+    report.insert("games", benchmark.games());
+    report.insert("moves", benchmark.moves());
+
+    bool growing = false;
+    if (soak) {
+        QJsonArray samples;
+        foreach(const GuiBenchmark::Sample& sample, benchmark.samples()) {
+            QJsonObject point;
+            point.insert("games", sample.games);
+            point.insert("residentKb", (qreal) sample.residentSize);
+            point.insert("heapKb", (qreal) sample.heapSize);
+            samples.append(point);
+        }
+        const qreal resident_growth = benchmark.residentGrowth();
+        const qreal heap_growth = benchmark.heapGrowth();
+        growing = resident_growth > max_growth || heap_growth > max_growth;
+        if (growing)
+            fprintf(stderr, "guibench: the memory grows %.0f kB resident and %.0f kB of heap per thousand games\n",
+                    resident_growth, heap_growth);
+        report.insert("samples", samples);
+        report.insert("residentGrowthKb", resident_growth);
+        report.insert("heapGrowthKb", heap_growth);
+        report.insert("growing", growing);
+    } else {
+        QJsonArray phases;
+        foreach(const GuiBenchmark::Result& result, benchmark.results()) {
+            QJsonObject phase;
+            phase.insert("name", result.name);
+            phase.insert("count", result.count);
+            phase.insert("meanUs", result.mean);
+            phase.insert("p50Us", result.p50);
+            phase.insert("p99Us", result.p99);
+            phase.insert("maxUs", result.max);
+            phase.insert("totalMs", result.total);
+            phases.append(phase);
+        }
+        report.insert("phases", phases);
+    }
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (output.isEmpty()) {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    } else {
+        QFile file(output);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            fprintf(stderr, "guibench: could not write %s\n", qPrintable(output));
+            return 1;
+        }
+    }
+    return finished && !growing ? 0 : 1;
+}
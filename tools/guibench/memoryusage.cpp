@@ -0,0 +1,54 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "memoryusage.h"
+#include <QFile>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+qint64 MemoryUsage::residentSize()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    // the size of the file is 0, it is read to its end; the line is such as "VmRSS:	   52344 kB"
+    foreach(const QByteArray& line, file.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+#endif
+    return -1;
+}
+
+qint64 MemoryUsage::heapSize()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    // the big blocks are mapped apart from the arenas
+    struct mallinfo2 info = mallinfo2();
+    return (qint64) (info.uordblks + info.hblkhd)/1024;
+#elif defined(__GLIBC__)
+    // the fields of the older mallinfo wrap above 2 GB, far above the board
+    struct mallinfo info = mallinfo();
+    return ((qint64) (unsigned int) info.uordblks + (unsigned int) info.hblkhd)/1024;
+#else
+    return -1;
+#endif
+}
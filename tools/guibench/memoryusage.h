@@ -0,0 +1,45 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <QtGlobal>
+
+/**    @brief The class MemoryUsage tells the memory that the process holds: its
+ *    resident size, and the heap in use, which is what malloc has given out and
+ *    not taken back, the allocations of new and of the containers of Qt alike.
+ *    The heap is known on glibc only.
+ */
+class MemoryUsage
+{
+public:
+    /**
+     * @brief residentSize the resident set size of the process
+     * @return qint64 the size in kilobytes, -1 if it is not known
+     */
+    static qint64 residentSize();
+    /**
+     * @brief heapSize the memory that malloc has given out and not taken back
+     * @return qint64 the size in kilobytes, -1 if it is not known
+     */
+    static qint64 heapSize();
+};
+
+#endif // MEMORYUSAGE_H
@@ -0,0 +1,171 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+
+/**
+ * replay feeds the games of the record files that the game writes back through
+ * the solver, as fast as it goes, and compares the time of the solver with the
+ * recorded one, to catch the performance regressions on real games.
+ *
+ * usage: replay [--no-book] [--max-ratio R] FILE...
+ *
+ * Every recorded guess is searched again and then played, whatever the solver
+ * finds, so that the replayed game follows the recorded one. The first guess is
+ * shuffled by the solver, so it usually differs. The ratio is the
+ * replayed time over the recorded time of the timed turns. With --max-ratio,
+ * replay fails if the ratio is above R.
+ */
+
+#include "solver.h"
+#include "guess.h"
+#include "gamerecord.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <cstdio>
+
+/**
+ * @brief The Totals struct
+ * The sums over the replayed games
+ */
+struct Totals {
+    int games;
+    int turns;
+    int timedTurns; /**< the turns with a recorded time */
+    int differentGuesses; /**< the turns that the solver guesses differently */
+    qint64 recorded; /**< the recorded time of the timed turns in microseconds */
+    qint64 replayed; /**< the replayed time of the timed turns in microseconds */
+    qint64 total; /**< the replayed time of all the turns in microseconds */
+};
+
+/**
+ * @brief replay play a recorded game on a fresh solver
+ * @param entry the game
+ * @param use_book look up the opening book, as the game does
+ * @param totals the sums to add the game to
+ * @return true if the game is consistent, false otherwise
+ */
+static bool replay(const GameRecord::Entry& entry, const bool& use_book, Totals* totals)
+{
+    if (entry.colors < MIN_COLOR_NUMBER || entry.colors > MAX_COLOR_NUMBER ||
+            entry.pegs < MIN_SLOT_NUMBER || entry.pegs > MAX_SLOT_NUMBER)
+        return false;
+
+    Guess guess;
+    unsigned char secret[MAX_SLOT_NUMBER];
+    for(int i = 0; i < entry.pegs; ++i)
+        secret[i] = entry.secret[i];
+    guess.setCode(entry.pegs, secret);
+
+    Solver solver(&guess);
+    if (!use_book)
+        solver.setOpeningBook(0);
+    // the guesses of the previous games would be found, not searched
+    solver.setTranspositionTable(0);
+    guess.reset(entry.algorithm, solver.reset(entry.colors, entry.pegs, entry.sameColors));
+
+    QElapsedTimer timer;
+    foreach(const GameRecord::Turn& turn, entry.turns) {
+        timer.start();
+        solver.startGuessing(entry.algorithm, entry.engine);
+        solver.wait();
+        qint64 elapsed = timer.nsecsElapsed()/1000;
+
+        ++totals->turns;
+        totals->total += elapsed;
+        if (turn.elapsed) {
+            ++totals->timedTurns;
+            totals->recorded += turn.elapsed;
+            totals->replayed += elapsed;
+        }
+        for(int i = 0; i < entry.pegs; ++i) {
+            if (guess.guess()[i] != turn.guess[i]) {
+                ++totals->differentGuesses;
+                break;
+            }
+        }
+
+        int total = 0;
+        while ((total + 1)*(total + 2)/2 <= turn.response)
+            ++total;
+        int blacks = turn.response - total*(total + 1)/2;
+        if (!solver.setResponse(blacks, total - blacks, turn.guess))
+            return false;
+    }
+    ++totals->games;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VER);
+
+    bool use_book = true;
+    double max_ratio = 0;
+    QStringList files;
+
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size(); ++i) {
+        if (args.at(i) == "--no-book") {
+            use_book = false;
+        } else if (args.at(i) == "--max-ratio" && i + 1 < args.size()) {
+            max_ratio = args.at(++i).toDouble();
+        } else if (!args.at(i).startsWith("--")) {
+            files.append(args.at(i));
+        } else {
+            files.clear();
+            break;
+        }
+    }
+    if (files.isEmpty()) {
+        fprintf(stderr, "usage: replay [--no-book] [--max-ratio R] FILE...\n");
+        return 1;
+    }
+
+    // the speed is measured before the first timed turn
+    Solver::measureDefaultSpeed();
+    Totals totals = {0, 0, 0, 0, 0, 0, 0};
+    int inconsistent = 0;
+    foreach(const QString& file, files) {
+        QList<GameRecord::Entry> entries;
+        if (!GameRecord::read(file, &entries)) {
+            fprintf(stderr, "replay: %s is not a game record\n", qPrintable(file));
+            return 1;
+        }
+        foreach(const GameRecord::Entry& entry, entries)
+            if (!replay(entry, use_book, &totals))
+                ++inconsistent;
+    }
+
+    double ratio = totals.recorded ? (double) totals.replayed/totals.recorded : 0;
+    printf("games %d, turns %d, different guesses %d, inconsistent games %d\n",
+           totals.games, totals.turns, totals.differentGuesses, inconsistent);
+    printf("replayed %.3f ms, %.3f ms a turn\n", totals.total/1000.0,
+           totals.turns ? totals.total/1000.0/totals.turns : 0.0);
+    printf("timed turns %d, recorded %.3f ms, replayed %.3f ms, ratio %.3f\n",
+           totals.timedTurns, totals.recorded/1000.0, totals.replayed/1000.0, ratio);
+
+    if (max_ratio > 0 && ratio > max_ratio) {
+        fprintf(stderr, "replay: the ratio %.3f is above %.3f\n", ratio, max_ratio);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# replay plays the recorded games through the solver
+#
+#-------------------------------------------------
+
+QT	   += core
+QT	   -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+CONFIG += console
+CONFIG -= app_bundle
+
+MOC_DIR = build
+OBJECTS_DIR = build
+
+TEMPLATE = app
+TARGET = replay
+
+include(../../src/core.pri)
+
+SOURCES += main.cpp
+
+OTHER_FILES += \
+	replay.qbs
@@ -0,0 +1,266 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+
+/**
+ * selfplay plays the solver against a scripted code maker, for every secret
+ * code of a configuration or a random sample of them, without the game, and
+ * writes a JSON report of the guesses and of the time of the turns.
+ *
+ * usage: selfplay [--colors C] [--pegs P] [--distinct-colors]
+ *                 [--algorithm most-parts|worst-case|expected-size|entropy|optimal]
+ *                 [--engine one-step|look-ahead|auto] [--sample N] [--seed S]
+ *                 [--jobs N] [--no-book] [--output FILE]
+ *
+ * The games run in parallel on --jobs threads, one per core by default. Every
+ * game has a fresh solver with no transposition table, so that the games do
+ * not depend on each other, and the opening book is looked up as in the game
+ * unless --no-book is given.
+ */
+
+#include "solver.h"
+#include "guess.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cstdio>
+
+static const int MAX_GUESSES = 20; /**< The guesses after which a game is lost */
+
+/**
+ * @brief The Play struct
+ * A game of the solver against a secret code
+ */
+struct Play {
+    int colors;
+    int pegs;
+    bool sameColors;
+    Algorithm algorithm;
+    Engine engine;
+    bool useBook;
+    unsigned char secret[MAX_SLOT_NUMBER];
+    int guesses; /**< the number of guesses to find the secret, 0 if not found */
+    QVector<qint64> latencies; /**< the time of each turn in microseconds */
+};
+
+/**
+ * @brief play play a game, the code maker gives the true response of each guess
+ * @param play the game
+ */
+static void play(Play& play)
+{
+    Guess guess;
+    guess.setCode(play.pegs, play.secret);
+
+    Solver solver(&guess);
+    if (!play.useBook)
+        solver.setOpeningBook(0);
+    solver.setTranspositionTable(0);
+    guess.reset(play.algorithm, solver.reset(play.colors, play.pegs, play.sameColors));
+
+    play.guesses = 0;
+    QElapsedTimer timer;
+    for(int turn = 1; turn <= MAX_GUESSES; ++turn) {
+        timer.start();
+        solver.startGuessing(play.algorithm, play.engine);
+        solver.wait();
+        play.latencies.append(timer.nsecsElapsed()/1000);
+
+        int blacks, whites;
+        COMPARE(play.secret, guess.guess(), play.colors, play.pegs, blacks, whites);
+        if (blacks == play.pegs) {
+            play.guesses = turn;
+            return;
+        }
+        if (!solver.setResponse(blacks, whites, guess.guess()))
+            return;
+    }
+}
+
+/**
+ * @brief percentile the value under which a fraction of the sorted values are
+ * @param values the sorted values
+ * @param fraction the fraction, between 0 and 1
+ */
+static qint64 percentile(const QVector<qint64>& values, const qreal& fraction)
+{
+    if (values.isEmpty())
+        return 0;
+    return values.at(qRound(fraction*(values.size() - 1)));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VER);
+
+    QStringList algorithm_names;
+    algorithm_names << "most-parts" << "worst-case" << "expected-size" << "entropy" << "optimal";
+    QStringList engine_names;
+    engine_names << "one-step" << "look-ahead" << "auto";
+
+    int colors = 6;
+    int pegs = 4;
+    bool same_colors = true;
+    int algorithm = static_cast<int>(Algorithm::EXPECTED_SIZE);
+    int engine = static_cast<int>(Engine::ONE_STEP);
+    int sample = 0;
+    uint seed = 1;
+    int jobs = QThread::idealThreadCount();
+    bool use_book = true;
+    QString output;
+
+    bool valid = true;
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size() && valid; ++i) {
+        if (args.at(i) == "--colors" && i + 1 < args.size()) {
+            colors = args.at(++i).toInt();
+        } else if (args.at(i) == "--pegs" && i + 1 < args.size()) {
+            pegs = args.at(++i).toInt();
+        } else if (args.at(i) == "--distinct-colors") {
+            same_colors = false;
+        } else if (args.at(i) == "--algorithm" && i + 1 < args.size()) {
+            algorithm = algorithm_names.indexOf(args.at(++i));
+            valid = (algorithm >= 0);
+        } else if (args.at(i) == "--engine" && i + 1 < args.size()) {
+            engine = engine_names.indexOf(args.at(++i));
+            valid = (engine >= 0);
+        } else if (args.at(i) == "--sample" && i + 1 < args.size()) {
+            sample = args.at(++i).toInt();
+        } else if (args.at(i) == "--seed" && i + 1 < args.size()) {
+            seed = args.at(++i).toUInt();
+        } else if (args.at(i) == "--jobs" && i + 1 < args.size()) {
+            jobs = args.at(++i).toInt();
+        } else if (args.at(i) == "--no-book") {
+            use_book = false;
+        } else if (args.at(i) == "--output" && i + 1 < args.size()) {
+            output = args.at(++i);
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || colors < MIN_COLOR_NUMBER || colors > MAX_COLOR_NUMBER || pegs < MIN_SLOT_NUMBER ||
+            pegs > MAX_SLOT_NUMBER || (!same_colors && pegs > colors) || jobs < 1) {
+        fprintf(stderr, "usage: selfplay [--colors C] [--pegs P] [--distinct-colors]\n"
+                        "                [--algorithm most-parts|worst-case|expected-size|entropy|optimal]\n"
+                        "                [--engine one-step|look-ahead|auto] [--sample N] [--seed S]\n"
+                        "                [--jobs N] [--no-book] [--output FILE]\n");
+        return 1;
+    }
+
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(colors, pegs, same_colors);
+    QVector<int> secrets;
+    if (sample > 0 && sample < tables->size()) {
+        // a partial shuffle, the first codes are the sample
+        QVector<int> codes(tables->size());
+        for(int i = 0; i < codes.size(); ++i)
+            codes[i] = i;
+        qsrand(seed);
+        for(int i = 0; i < sample; ++i) {
+            int j = i + qrand() % (codes.size() - i);
+            qSwap(codes[i], codes[j]);
+            secrets.append(codes.at(i));
+        }
+    } else {
+        for(int i = 0; i < tables->size(); ++i)
+            secrets.append(i);
+    }
+
+    QVector<Play> plays(secrets.size());
+    for(int i = 0; i < secrets.size(); ++i) {
+        Play& game = plays[i];
+        game.colors = colors;
+        game.pegs = pegs;
+        game.sameColors = same_colors;
+        game.algorithm = static_cast<Algorithm>(algorithm);
+        game.engine = static_cast<Engine>(engine);
+        game.useBook = use_book;
+        for(int j = 0; j < pegs; ++j)
+            game.secret[j] = tables->code(secrets.at(i))[j];
+    }
+
+    Solver::measureDefaultSpeed();
+    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(plays, play);
+    const qint64 elapsed = timer.elapsed();
+
+    int solved = 0;
+    int max_guesses = 0;
+    qint64 total_guesses = 0;
+    QVector<int> distribution(MAX_GUESSES + 1, 0);
+    QVector<qint64> latencies;
+    foreach(const Play& game, plays) {
+        latencies += game.latencies;
+        ++distribution[game.guesses];
+        if (game.guesses) {
+            ++solved;
+            total_guesses += game.guesses;
+            max_guesses = qMax(max_guesses, game.guesses);
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    QJsonObject guesses;
+    for(int i = 1; i <= MAX_GUESSES; ++i)
+        if (distribution.at(i))
+            guesses.insert(QString::number(i), distribution.at(i));
+    QJsonObject latency;
+    latency.insert("p50", percentile(latencies, 0.5)/1000.0);
+    latency.insert("p99", percentile(latencies, 0.99)/1000.0);
+    latency.insert("max", percentile(latencies, 1)/1000.0);
+
+    QJsonObject report;
+    report.insert("colors", colors);
+    report.insert("pegs", pegs);
+    report.insert("sameColors", same_colors);
+    report.insert("algorithm", algorithm_names.at(algorithm));
+    report.insert("engine", engine_names.at(engine));
+    report.insert("book", use_book);
+    report.insert("games", plays.size());
+    report.insert("unsolved", plays.size() - solved);
+    report.insert("meanGuesses", solved ? (qreal) total_guesses/solved : 0.0);
+    report.insert("maxGuesses", max_guesses);
+    report.insert("guesses", guesses);
+    report.insert("turns", latencies.size());
+    report.insert("latencyMs", latency);
+    report.insert("elapsedMs", elapsed);
+    report.insert("jobs", jobs);
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (output.isEmpty()) {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    } else {
+        QFile file(output);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            fprintf(stderr, "selfplay: could not write %s\n", qPrintable(output));
+            return 1;
+        }
+    }
+    return solved == plays.size() ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# selfplay plays the solver against every secret code
+#
+#-------------------------------------------------
+
+QT	   += core
+QT	   -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+CONFIG += console
+CONFIG -= app_bundle
+
+MOC_DIR = build
+OBJECTS_DIR = build
+
+TEMPLATE = app
+TARGET = selfplay
+
+include(../../src/core.pri)
+
+SOURCES += main.cpp
+
+OTHER_FILES += \
+	selfplay.qbs
@@ -0,0 +1,165 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+/**
+ * solverbench times the hot steps of the solver for every configuration, and
+ * compares them with a baseline, the output of an earlier run.
+ *
+ * usage: solverbench [--samples N] [--filter TEXT] [--output FILE] [--counters]
+ *                    [--baseline FILE [--tolerance PERCENT]]
+ *
+ * The JSON output has the median and the median absolute deviation of each
+ * step in nanoseconds. With --baseline, a step is a regression if its median
+ * is more than --tolerance percent (5 by default) and more than three
+ * deviations above the baseline, and solverbench then fails.
+ *
+ * With --counters, the hardware events of an iteration of each step are added,
+ * on Linux if perf_event_open is allowed (see perf_event_paranoid), with the
+ * instructions per cycle and, for the steps that compare codes, the misses per
+ * comparison. The timings are reported the same without them.
+ */
+
+#include "solverbenchmark.h"
+#include "appinfo.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(APP_NAME);
+    app.setApplicationVersion(APP_VER);
+
+    int samples = 11;
+    QString filter;
+    QString output;
+    QString baseline;
+    qreal tolerance = 5;
+    bool counters = false;
+
+    QStringList args = app.arguments();
+    for(int i = 1; i < args.size(); ++i) {
+        if (args.at(i) == "--samples" && i + 1 < args.size()) {
+            samples = args.at(++i).toInt();
+        } else if (args.at(i) == "--filter" && i + 1 < args.size()) {
+            filter = args.at(++i);
+        } else if (args.at(i) == "--output" && i + 1 < args.size()) {
+            output = args.at(++i);
+        } else if (args.at(i) == "--baseline" && i + 1 < args.size()) {
+            baseline = args.at(++i);
+        } else if (args.at(i) == "--tolerance" && i + 1 < args.size()) {
+            tolerance = args.at(++i).toDouble();
+        } else if (args.at(i) == "--counters") {
+            counters = true;
+        } else {
+            samples = 0;
+            break;
+        }
+    }
+    if (samples < 1) {
+        fprintf(stderr, "usage: solverbench [--samples N] [--filter TEXT] [--output FILE] [--counters]\n"
+                        "                   [--baseline FILE [--tolerance PERCENT]]\n");
+        return 1;
+    }
+
+    // the median and the deviation of each step of the baseline
+    QHash<QString, QJsonObject> baseline_results;
+    if (!baseline.isEmpty()) {
+        QFile file(baseline);
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "solverbench: could not read %s\n", qPrintable(baseline));
+            return 1;
+        }
+        QJsonArray steps = QJsonDocument::fromJson(file.readAll()).object().value("benchmarks").toArray();
+        for(int i = 0; i < steps.size(); ++i)
+            baseline_results.insert(steps.at(i).toObject().value("name").toString(), steps.at(i).toObject());
+    }
+
+    SolverBenchmark benchmark(samples, filter, counters);
+    if (counters && !benchmark.hasCounters())
+        fprintf(stderr, "solverbench: the hardware counters are not available, only the times are reported\n");
+    benchmark.run();
+
+    int regressions = 0;
+    QJsonArray steps;
+    foreach(const SolverBenchmark::Result& result, benchmark.results()) {
+        QJsonObject step;
+        step.insert("name", result.name);
+        step.insert("medianNs", result.median);
+        step.insert("madNs", result.mad);
+        step.insert("samples", result.samples);
+        step.insert("iterations", result.iterations);
+        if (result.comparisons > 0)
+            step.insert("comparisons", result.comparisons);
+        if (benchmark.hasCounters()) {
+            QJsonObject events;
+            QJsonObject per_comparison;
+            for(int i = 0; i < PerfCounters::EVENTS; ++i) {
+                if (result.counters[i] < 0)
+                    continue;
+                const PerfCounters::Event event = static_cast<PerfCounters::Event>(i);
+                events.insert(PerfCounters::name(event), result.counters[i]);
+                if (result.comparisons > 0)
+                    per_comparison.insert(PerfCounters::name(event), result.counters[i]/result.comparisons);
+            }
+            if (result.counters[PerfCounters::CYCLES] > 0 && result.counters[PerfCounters::INSTRUCTIONS] >= 0)
+                events.insert("ipc", result.counters[PerfCounters::INSTRUCTIONS]/result.counters[PerfCounters::CYCLES]);
+            if (!per_comparison.isEmpty())
+                events.insert("perComparison", per_comparison);
+            step.insert("counters", events);
+        }
+        if (baseline_results.contains(result.name)) {
+            const QJsonObject base = baseline_results.value(result.name);
+            const qreal base_median = base.value("medianNs").toDouble();
+            const qreal deviation = qMax(result.mad, base.value("madNs").toDouble());
+            const bool regression = result.median > base_median*(1 + tolerance/100) &&
+                    result.median - base_median > 3*deviation;
+            step.insert("baselineNs", base_median);
+            step.insert("regression", regression);
+            if (regression) {
+                ++regressions;
+                fprintf(stderr, "regression: %s %.1f ns -> %.1f ns (%+.1f%%)\n", qPrintable(result.name),
+                        base_median, result.median, 100*(result.median/base_median - 1));
+            }
+        }
+        steps.append(step);
+    }
+
+    QJsonObject report;
+    report.insert("benchmarks", steps);
+    if (!baseline.isEmpty())
+        report.insert("regressions", regressions);
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (output.isEmpty()) {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    } else {
+        QFile file(output);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            fprintf(stderr, "solverbench: could not write %s\n", qPrintable(output));
+            return 1;
+        }
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "perfcounters.h"
+
+#ifdef Q_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+PerfCounters::PerfCounters()
+{
+    for(int i = 0; i < EVENTS; ++i) {
+        mFds[i] = -1;
+        mValues[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef Q_OS_LINUX
+    for(int i = 0; i < EVENTS; ++i)
+        if (mFds[i] >= 0)
+            close(mFds[i]);
+#endif
+}
+
+bool PerfCounters::open()
+{
+    bool available = false;
+#ifdef Q_OS_LINUX
+    static const quint32 types[EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                          PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+    static const quint64 configs[EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for(int i = 0; i < EVENTS; ++i) {
+        if (mFds[i] >= 0)
+            continue;
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // this thread, on any processor
+        mFds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        available |= (mFds[i] >= 0);
+    }
+#endif
+    return available;
+}
+
+void PerfCounters::start()
+{
+#ifdef Q_OS_LINUX
+    for(int i = 0; i < EVENTS; ++i) {
+        if (mFds[i] >= 0) {
+            ioctl(mFds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(mFds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::stop()
+{
+#ifdef Q_OS_LINUX
+    for(int i = 0; i < EVENTS; ++i)
+        if (mFds[i] >= 0)
+            ioctl(mFds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+    for(int i = 0; i < EVENTS; ++i) {
+        mValues[i] = -1;
+        // the count, the time the counter was enabled and the time it was running
+        quint64 values[3];
+        if (mFds[i] < 0 || read(mFds[i], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+            continue;
+        mValues[i] = (values[2] < values[1]) ? (qint64) ((double) values[0]*values[1]/values[2]) : values[0];
+    }
+#endif
+}
+
+const char* PerfCounters::name(const Event& event)
+{
+    static const char* names[EVENTS] = {"cycles", "instructions", "l1Misses", "llcMisses", "branchMisses"};
+    return names[event];
+}
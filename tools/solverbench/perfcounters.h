@@ -0,0 +1,74 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QtGlobal>
+
+/**    @brief The class PerfCounters counts the hardware events of the running
+ *    thread through the perf_event_open system call of Linux. Each event has
+ *    its own counter, so an event that the processor or the kernel does not
+ *    offer, as in many virtual machines, leaves the others working. Elsewhere,
+ *    or when perf_event_paranoid does not allow it, no counter is available.
+ */
+class PerfCounters
+{
+public:
+
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1_MISSES, /**< the read misses of the L1 data cache */
+        LLC_MISSES, /**< the misses of the last level cache */
+        BRANCH_MISSES,
+        EVENTS
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    /**
+     * @brief open open a counter for each event
+     * @return bool is any counter available?
+     */
+    bool open();
+    bool isAvailable(const Event& event) const {return mFds[event] >= 0;}
+    /**
+     * @brief start reset and start the counters
+     */
+    void start();
+    /**
+     * @brief stop stop the counters and read them
+     */
+    void stop();
+    /**
+     * @brief value the count of an event between the last start and stop,
+     * scaled up if the kernel shared the counter with others
+     * @return qint64 the count, -1 if the counter is not available
+     */
+    qint64 value(const Event& event) const {return mValues[event];}
+    static const char* name(const Event& event);
+
+private:
+    int mFds[EVENTS]; /**< the file descriptor of each counter, -1 if not available */
+    qint64 mValues[EVENTS]; /**< the counts of the last start and stop */
+};
+
+#endif // PERFCOUNTERS_H
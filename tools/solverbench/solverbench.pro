@@ -0,0 +1,31 @@
+#-------------------------------------------------
+#
+# solverbench times the hot steps of the solver
+#
+#-------------------------------------------------
+
+QT	   += core
+QT	   -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+CONFIG += console
+CONFIG -= app_bundle
+
+MOC_DIR = build
+OBJECTS_DIR = build
+
+TEMPLATE = app
+TARGET = solverbench
+
+include(../../src/core.pri)
+
+SOURCES += main.cpp \
+	perfcounters.cpp \
+	solverbenchmark.cpp
+
+HEADERS += perfcounters.h \
+	solverbenchmark.h
+
+OTHER_FILES += \
+	solverbench.qbs
@@ -0,0 +1,215 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#include "solverbenchmark.h"
+#include "solver.h"
+#include "guess.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdio>
+
+static const qint64 SAMPLE_TIME = 2000000; /**< The least time of a sample in nanoseconds */
+static const qint64 MAX_ITERATIONS = 1 << 20; /**< The most iterations of a sample */
+
+/**
+ * @brief median the median of some values
+ */
+static qreal median(QVector<qreal> values)
+{
+    std::sort(values.begin(), values.end());
+    const int half = values.size()/2;
+    return (values.size() % 2) ? values.at(half) : (values.at(half - 1) + values.at(half))/2;
+}
+
+SolverBenchmark::SolverBenchmark(const int& samples, const QString& filter, const bool& counters):
+    mSamples(samples),
+    mFilter(filter),
+    mHasCounters(counters && mCounters.open())
+{
+}
+
+void SolverBenchmark::run()
+{
+    for(int colors = MIN_COLOR_NUMBER; colors <= MAX_COLOR_NUMBER; ++colors)
+        for(int pegs = MIN_SLOT_NUMBER; pegs <= MAX_SLOT_NUMBER; ++pegs)
+            for(int same = 1; same >= 0; --same)
+                if (same || pegs <= colors)
+                    runConfiguration(colors, pegs, same);
+
+    for(int pegs = MIN_SLOT_NUMBER; pegs <= MAX_SLOT_NUMBER; ++pegs)
+        runWeights(pegs);
+}
+
+void SolverBenchmark::runConfiguration(const int& colors, const int& pegs, const bool& same_colors)
+{
+    const QString configuration = QString("%1x%2%3").arg(colors).arg(pegs).arg(same_colors ? "" : "-distinct");
+
+    // the tables are built from scratch, not taken from the shared ones
+    measure("createTables/" + configuration, [&]() {
+        delete new CodeTables(colors, pegs, same_colors);
+    });
+
+    QSharedPointer<const CodeTables> tables = CodeTables::acquire(colors, pegs, same_colors);
+    const int size = tables->size();
+    if (same_colors) {
+        measure("nextCodeSameColor/" + configuration, [&]() {
+            unsigned char X[MAX_SLOT_NUMBER] = {0, 0, 0, 0, 0};
+            for(int i = 1; i < size; ++i)
+                tables->nextCodeSameColor(X);
+        });
+    } else {
+        measure("nextCodeDifferentColor/" + configuration, [&]() {
+            unsigned char X[MAX_SLOT_NUMBER] = {0, 1, 2, 3, 4};
+            for(int i = 1; i < size; ++i)
+                tables->nextCodeDifferentColor(X);
+        });
+    }
+
+    int pair = 0;
+    volatile int responses = 0; // keeps the comparisons from being optimized away
+    measure("compare/" + configuration, [&]() {
+        const unsigned char* A = tables->code(pair);
+        const unsigned char* B = tables->code((pair*7919LL) % size);
+        int blacks, whites;
+        COMPARE(A, B, colors, pegs, blacks, whites);
+        responses += blacks + whites;
+        pair = (pair + 1) % size;
+    }, 1);
+
+    // the second turn of a game, after the first guess of Expected Size
+    Guess guess;
+    Solver solver(&guess);
+    solver.setOpeningBook(0);
+    solver.setTranspositionTable(0);
+    guess.reset(Algorithm::EXPECTED_SIZE, solver.reset(colors, pegs, same_colors));
+    unsigned char first_guess[MAX_SLOT_NUMBER];
+    solver.firstGuess(Algorithm::EXPECTED_SIZE, first_guess);
+    int blacks, whites;
+    COMPARE(tables->code(size/3), first_guess, colors, pegs, blacks, whites);
+
+    // the filter compares every possible with the guess, the undo compares nothing
+    measure("setResponse/" + configuration, [&]() {
+        solver.setResponse(blacks, whites, first_guess);
+        solver.undoResponse();
+    }, solver.mPossibles.size());
+
+    solver.setResponse(blacks, whites, first_guess);
+    solver.mAlgorithm = Algorithm::EXPECTED_SIZE;
+    solver.mEngine = Engine::ONE_STEP;
+    solver.mInterupt = false;
+    // each candidate is compared with every possible, unless there are too many to weigh
+    const int possibles = solver.mPossibles.size();
+    const qint64 candidates = (possibles > 1 && possibles <= Solver::calibration().exactLimit) ?
+                solver.reduceCandidates().size() : 0;
+    measure("makeGuess/" + configuration, [&]() {
+        solver.makeGuess();
+    }, candidates*possibles);
+}
+
+void SolverBenchmark::runWeights(const int& pegs)
+{
+    static const char* algorithm_names[] = {"most-parts", "worst-case", "expected-size", "entropy"};
+    const int colors = 6;
+
+    // the partition of all the codes by the first guess
+    Guess guess;
+    Solver solver(&guess);
+    solver.setOpeningBook(0);
+    solver.setTranspositionTable(0);
+    solver.reset(colors, pegs, true);
+    unsigned char first_guess[MAX_SLOT_NUMBER];
+    solver.firstGuess(Algorithm::EXPECTED_SIZE, first_guess);
+    QVector<int> partition(solver.mMaxResponse, 0);
+    for(int i = 0; i < solver.mTables->size(); ++i) {
+        int blacks, whites;
+        COMPARE(solver.mTables->code(i), first_guess, colors, pegs, blacks, whites);
+        ++partition[(blacks + whites)*(blacks + whites + 1)/2 + blacks];
+    }
+
+    QVector<int> parts(solver.mMaxResponse);
+    volatile qreal weights = 0; // keeps the weights from being optimized away
+    for(int algorithm = 0; algorithm < 4; ++algorithm) {
+        solver.mAlgorithm = static_cast<Algorithm>(algorithm);
+        measure(QString("computeWeight/%1/%2x%3").arg(algorithm_names[algorithm]).arg(colors).arg(pegs), [&]() {
+            // the weight clears the parts, as in a guess
+            std::copy(partition.constBegin(), partition.constEnd(), parts.begin());
+            weights += solver.computeWeight(parts.data());
+        });
+    }
+}
+
+template<typename Operation>
+void SolverBenchmark::measure(const QString& name, Operation operation, const qint64& comparisons)
+{
+    if (!mFilter.isEmpty() && !name.contains(mFilter))
+        return;
+
+    // the warm up, until a sample is long enough for the resolution of the timer
+    QElapsedTimer timer;
+    qint64 iterations = 1;
+    forever {
+        timer.start();
+        for(qint64 i = 0; i < iterations; ++i)
+            operation();
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (elapsed >= SAMPLE_TIME || iterations >= MAX_ITERATIONS)
+            break;
+        iterations = qMin(MAX_ITERATIONS, 2*iterations*SAMPLE_TIME/qMax(elapsed, (qint64) 1) + 1);
+    }
+
+    QVector<qreal> samples;
+    if (mHasCounters)
+        mCounters.start();
+    for(int sample = 0; sample < mSamples; ++sample) {
+        timer.start();
+        for(qint64 i = 0; i < iterations; ++i)
+            operation();
+        samples.append((qreal) timer.nsecsElapsed()/iterations);
+    }
+    if (mHasCounters)
+        mCounters.stop();
+
+    Result result;
+    result.name = name;
+    result.median = median(samples);
+    QVector<qreal> deviations;
+    foreach(qreal sample, samples)
+        deviations.append(qAbs(sample - result.median));
+    result.mad = median(deviations);
+    result.samples = mSamples;
+    result.iterations = iterations;
+    result.comparisons = comparisons;
+    for(int i = 0; i < PerfCounters::EVENTS; ++i) {
+        const qint64 value = mHasCounters ? mCounters.value(static_cast<PerfCounters::Event>(i)) : -1;
+        result.counters[i] = (value < 0) ? -1 : (qreal) value/(iterations*mSamples);
+    }
+    mResults.append(result);
+
+    fprintf(stderr, "%-40s %14.1f ns  +- %.1f", qPrintable(name), result.median, result.mad);
+    const qreal* counters = result.counters;
+    if (counters[PerfCounters::CYCLES] > 0 && counters[PerfCounters::INSTRUCTIONS] >= 0)
+        fprintf(stderr, "  IPC %.2f", counters[PerfCounters::INSTRUCTIONS]/counters[PerfCounters::CYCLES]);
+    if (comparisons > 0) {
+        static const char* labels[] = {"cycles", "instructions", "L1", "LLC", "branch"};
+        for(int i = PerfCounters::L1_MISSES; i < PerfCounters::EVENTS; ++i)
+            if (counters[i] >= 0)
+                fprintf(stderr, "  %s %.3f/cmp", labels[i], counters[i]/comparisons);
+    }
+    fputc('\n', stderr);
+}
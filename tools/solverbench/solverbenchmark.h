@@ -0,0 +1,107 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2013 Omid Nikta <omidnikta@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ***********************************************************************/
+
+#ifndef SOLVERBENCHMARK_H
+#define SOLVERBENCHMARK_H
+
+#include "perfcounters.h"
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**    @brief The class SolverBenchmark times the hot steps of the solver, the code
+ *    comparison, the filter of a response, the guess of a turn, the weight of a
+ *    partition and the building of the code tables, for every configuration.
+ *
+ *    Each step is first run until it takes some milliseconds, which warms up
+ *    the caches and finds the iterations of a sample, and then timed for some
+ *    samples. The time of a step is the median of the samples, and its spread
+ *    is their median absolute deviation, which a slow sample does not move.
+ *
+ *    With the hardware counters, the events of all the samples of a step are
+ *    counted too, so that a slow step tells if it waits for the memory or
+ *    mispredicts its branches. The steps that compare codes also tell their
+ *    comparisons, and the events are then reported per comparison.
+ */
+class SolverBenchmark
+{
+public:
+
+    /**
+    * @brief The Result struct
+    * The time of a step
+    */
+    struct Result {
+        QString name; /**< the step and its configuration, such as makeGuess/6x4 */
+        qreal median; /**< the median time of an iteration in nanoseconds */
+        qreal mad; /**< the median absolute deviation in nanoseconds */
+        int samples;
+        int iterations; /**< the iterations of a sample */
+        qint64 comparisons; /**< the code comparisons of an iteration, 0 if the step does not compare */
+        qreal counters[PerfCounters::EVENTS]; /**< the events of an iteration, -1 if not counted */
+    };
+
+    /**
+     * @brief SolverBenchmark
+     * @param samples the number of timed samples of each step
+     * @param filter only the steps whose names contain it, all if empty
+     * @param counters count the hardware events, if they are available
+     */
+    SolverBenchmark(const int& samples, const QString& filter, const bool& counters);
+
+    /**
+     * @brief run time all the steps of all the configurations
+     */
+    void run();
+
+    QList<Result> results() const {return mResults;}
+    /**
+     * @brief hasCounters are the hardware events counted?
+     */
+    bool hasCounters() const {return mHasCounters;}
+
+private:
+    /**
+     * @brief runConfiguration time the steps of a configuration
+     */
+    void runConfiguration(const int& colors, const int& pegs, const bool& same_colors);
+
+    /**
+     * @brief runWeights time the weight of a partition for each algorithm
+     */
+    void runWeights(const int& pegs);
+
+    /**
+     * @brief measure time an operation and keep its result
+     * @param name the name of the step
+     * @param operation the operation, called many times
+     * @param comparisons the code comparisons of an operation
+     */
+    template<typename Operation>
+    void measure(const QString& name, Operation operation, const qint64& comparisons = 0);
+
+private:
+    int mSamples; /**< the number of timed samples of each step */
+    QString mFilter; /**< only the steps whose names contain it */
+    QList<Result> mResults;
+    PerfCounters mCounters; /**< the hardware counters of the thread */
+    bool mHasCounters; /**< is any hardware event counted? */
+};
+
+#endif // SOLVERBENCHMARK_H